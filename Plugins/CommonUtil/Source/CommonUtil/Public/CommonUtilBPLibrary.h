@@ -164,6 +164,35 @@ namespace Tmp
 		static constexpr bool value = is_same_v<true_type, decltype(Conversion(nullptr))>;
 	};
 
+	//判断可调用对象F能否以Args调用,且返回值能隐式转换为Ret(编译期,不会真正调用)
+	template<typename Ret, typename F, typename... Args>
+	struct COMMONUTIL_API Is_Invocable_R
+	{
+	private:
+		static void Accept(Ret) {}
+
+		template<typename U, typename R = decltype(Accept(declval<U&>()(declval<Args>()...)))>
+		static true_type Test(void*);
+		template<typename U>
+		static false_type Test(...);
+	public:
+		static constexpr bool value = decltype(Test<F>(nullptr))::value;
+	};
+	//Ret为void时只判断能否调用,返回值被忽略
+	template<typename F, typename... Args>
+	struct COMMONUTIL_API Is_Invocable_R<void, F, Args...>
+	{
+	private:
+		template<typename U, typename R = decltype(declval<U&>()(declval<Args>()...))>
+		static true_type Test(void*);
+		template<typename U>
+		static false_type Test(...);
+	public:
+		static constexpr bool value = decltype(Test<F>(nullptr))::value;
+	};
+	template<typename Ret, typename F, typename... Args>
+	constexpr bool Is_Invocable_R_v = Is_Invocable_R<Ret, F, Args...>::value;
+
 	//判断一个类型是否是类类型
 	template<typename T>
 	struct COMMONUTIL_API Is_Calss
@@ -0,0 +1,143 @@
+﻿#include "DelayActionPool.h"
+#include "TryDelayStats.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actions"), STAT_TryDelay_PooledActions, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Blocks"), STAT_TryDelay_PooledBlocks, STATGROUP_TryDelay);
+
+static FAutoConsoleCommand CVarTryDelayPoolStats(
+	TEXT("TryDelay.PoolStats"),
+	TEXT("Log TryDelay action pool usage and high-water marks"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FDelayActionPool::Get().LogStats();
+	}));
+
+FDelayActionPool& FDelayActionPool::Get()
+{
+	static FDelayActionPool Pool;
+	return Pool;
+}
+
+FDelayActionPool::FDelayActionPool()
+{
+	for (int32 Index = 0; Index < NumSizeClasses; ++Index)
+	{
+		SizeClasses[Index].Stats.BlockSize = 64 << Index;
+	}
+}
+
+FDelayActionPool::~FDelayActionPool()
+{
+	for (FSizeClass& SizeClass : SizeClasses)
+	{
+		for (void* Page : SizeClass.Pages)
+		{
+			FMemory::Free(Page);
+		}
+		SizeClass.Pages.Reset();
+		SizeClass.FreeList = nullptr;
+	}
+}
+
+void* FDelayActionPool::Allocate(SIZE_T Size)
+{
+	uint8* Block = nullptr;
+	uint8 ClassIndex = HeapSizeClass;
+	const int32 NumPooledClasses = IsInGameThread() ? NumSizeClasses : 0;
+	for (int32 Index = 0; Index < NumPooledClasses; ++Index)
+	{
+		FSizeClass& SizeClass = SizeClasses[Index];
+		if (Size + HeaderSize <= (SIZE_T)SizeClass.Stats.BlockSize)
+		{
+			if (SizeClass.FreeList == nullptr)
+			{
+				AllocatePage(SizeClass);
+			}
+			Block = (uint8*)SizeClass.FreeList;
+			SizeClass.FreeList = SizeClass.FreeList->Next;
+
+			FSizeClassStats& Stats = SizeClass.Stats;
+			Stats.HighWater = FMath::Max(Stats.HighWater, ++Stats.NumUsed);
+			ClassIndex = (uint8)Index;
+			break;
+		}
+	}
+
+	if (Block == nullptr)
+	{
+		Block = (uint8*)FMemory::Malloc(Size + HeaderSize, HeaderSize);
+		NumHeapAllocations.IncrementExchange();
+	}
+
+	*Block = ClassIndex;
+	INC_DWORD_STAT(STAT_TryDelay_PooledActions);
+	return Block + HeaderSize;
+}
+
+void FDelayActionPool::Free(void* Ptr)
+{
+	if (Ptr == nullptr)
+	{
+		return;
+	}
+
+	uint8* Block = (uint8*)Ptr - HeaderSize;
+	const uint8 ClassIndex = *Block;
+	if (ClassIndex == HeapSizeClass)
+	{
+		FMemory::Free(Block);
+	}
+	else
+	{
+		check(IsInGameThread());
+		FSizeClass& SizeClass = SizeClasses[ClassIndex];
+		FFreeBlock* FreeBlock = (FFreeBlock*)Block;
+		FreeBlock->Next = SizeClass.FreeList;
+		SizeClass.FreeList = FreeBlock;
+		--SizeClass.Stats.NumUsed;
+	}
+	DEC_DWORD_STAT(STAT_TryDelay_PooledActions);
+}
+
+int32 FDelayActionPool::GetStats(TArray<FSizeClassStats>& OutStats) const
+{
+	OutStats.Reset(NumSizeClasses);
+	for (const FSizeClass& SizeClass : SizeClasses)
+	{
+		OutStats.Add(SizeClass.Stats);
+	}
+	return NumHeapAllocations.Load();
+}
+
+void FDelayActionPool::LogStats() const
+{
+	for (const FSizeClass& SizeClass : SizeClasses)
+	{
+		const FSizeClassStats& Stats = SizeClass.Stats;
+		UE_LOG(LogTemp, Log, TEXT("TryDelay Pool [%4d]: Used %d, Blocks %d, HighWater %d"), Stats.BlockSize, Stats.NumUsed, Stats.NumBlocks, Stats.HighWater);
+	}
+	UE_LOG(LogTemp, Log, TEXT("TryDelay Pool Heap Allocations: %d"), NumHeapAllocations.Load());
+}
+
+void FDelayActionPool::AllocatePage(FSizeClass& SizeClass)
+{
+	const int32 BlockSize = SizeClass.Stats.BlockSize;
+	uint8* Page = (uint8*)FMemory::Malloc(BlockSize * BlocksPerPage, HeaderSize);
+	SizeClass.Pages.Add(Page);
+	SizeClass.Stats.NumBlocks += BlocksPerPage;
+
+	for (int32 Index = BlocksPerPage - 1; Index >= 0; --Index)
+	{
+		FFreeBlock* FreeBlock = (FFreeBlock*)(Page + Index * BlockSize);
+		FreeBlock->Next = SizeClass.FreeList;
+		SizeClass.FreeList = FreeBlock;
+	}
+
+	int32 NumBlocks = 0;
+	for (const FSizeClass& Other : SizeClasses)
+	{
+		NumBlocks += Other.Stats.NumBlocks;
+	}
+	SET_DWORD_STAT(STAT_TryDelay_PooledBlocks, NumBlocks);
+}
@@ -0,0 +1,273 @@
+﻿#include "DelayTimingWheel.h"
+
+FDelayTimingWheel::FDelayTimingWheel()
+{
+	Reset();
+}
+
+void FDelayTimingWheel::Schedule(int32 Id, uint64 DeadlineTick)
+{
+	check(Id >= 0);
+	if (Id >= Links.Num())
+	{
+		Links.SetNum(Id + 1);
+	}
+
+	if (Links[Id].Slot != INDEX_NONE)
+	{
+		Unlink(Id);
+	}
+	else
+	{
+		++NumScheduled;
+	}
+
+	Links[Id].DeadlineTick = FMath::Max(DeadlineTick, CurrentTick + 1);
+	Link(Id, SlotFor(Links[Id].DeadlineTick));
+}
+
+void FDelayTimingWheel::Cancel(int32 Id)
+{
+	if (IsScheduled(Id))
+	{
+		Unlink(Id);
+		--NumScheduled;
+	}
+}
+
+bool FDelayTimingWheel::IsScheduled(int32 Id) const
+{
+	return Links.IsValidIndex(Id) && Links[Id].Slot != INDEX_NONE;
+}
+
+void FDelayTimingWheel::Advance(uint64 ToTick, TArray<int32>& OutDue)
+{
+	while (CurrentTick < ToTick)
+	{
+		//之间的刻度既没有到期的槽也没有需要下沉的槽,直接跳过
+		const uint64 NextTick = GetNextEventTick();
+		if (NextTick > ToTick)
+		{
+			CurrentTick = ToTick;
+			break;
+		}
+
+		CurrentTick = NextTick;
+		const int32 Index0 = (int32)(CurrentTick & (Level0Slots - 1));
+		if (Index0 == 0)
+		{
+			//低层转完一圈,依次把上层对应槽下沉
+			bool bWrapped = true;
+			for (int32 Level = 1; Level < NumLevels; ++Level)
+			{
+				const int32 Shift = Level0Bits + (Level - 1) * LevelNBits;
+				const int32 Index = (int32)((CurrentTick >> Shift) & (LevelNSlots - 1));
+				Cascade(Level0Slots + (Level - 1) * LevelNSlots + Index);
+				if (Index != 0)
+				{
+					bWrapped = false;
+					break;
+				}
+			}
+			if (bWrapped)
+			{
+				Cascade(OverflowSlot);
+			}
+		}
+
+		while (Heads[Index0] != INDEX_NONE)
+		{
+			const int32 Id = Heads[Index0];
+			Unlink(Id);
+			--NumScheduled;
+			OutDue.Add(Id);
+		}
+	}
+}
+
+bool FDelayTimingWheel::GetNextDeadlineTick(uint64& OutTick) const
+{
+	if (NumScheduled == 0)
+	{
+		return false;
+	}
+
+	//本圈结束前上层不会下沉,第0层本圈中的定时器一定最早
+	const int32 Offset0 = FindOccupied(0, Level0Slots, (int32)((CurrentTick + 1) & (Level0Slots - 1)));
+	const uint64 LastTick = CurrentTick | (Level0Slots - 1);
+	OutTick = Offset0 != INDEX_NONE ? CurrentTick + 1 + Offset0 : MAX_uint64;
+	if (OutTick <= LastTick)
+	{
+		return true;
+	}
+
+	//上层每层的槽按块的先后排列,只需看每层第一个非空的槽及溢出链表
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		const int32 Shift = Level0Bits + (Level - 1) * LevelNBits;
+		const int32 First = Level0Slots + (Level - 1) * LevelNSlots;
+		const int32 Offset = FindOccupied(First, LevelNSlots, (int32)(((CurrentTick >> Shift) + 1) & (LevelNSlots - 1)));
+		if (Offset != INDEX_NONE)
+		{
+			const int32 Slot = First + (int32)((((CurrentTick >> Shift) + 1) + Offset) & (LevelNSlots - 1));
+			for (int32 Id = Heads[Slot]; Id != INDEX_NONE; Id = Links[Id].Next)
+			{
+				OutTick = FMath::Min(OutTick, Links[Id].DeadlineTick);
+			}
+		}
+	}
+	for (int32 Id = Heads[OverflowSlot]; Id != INDEX_NONE; Id = Links[Id].Next)
+	{
+		OutTick = FMath::Min(OutTick, Links[Id].DeadlineTick);
+	}
+	return true;
+}
+
+void FDelayTimingWheel::Reset()
+{
+	for (int32& Head : Heads)
+	{
+		Head = INDEX_NONE;
+	}
+	for (uint64& Word : Occupied)
+	{
+		Word = 0;
+	}
+	Links.Reset();
+	NumScheduled = 0;
+}
+
+int32 FDelayTimingWheel::SlotFor(uint64 Tick) const
+{
+	const uint64 Delta = Tick - CurrentTick;
+	if (Delta < Level0Slots)
+	{
+		return (int32)(Tick & (Level0Slots - 1));
+	}
+
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		const int32 Shift = Level0Bits + Level * LevelNBits;
+		if (Delta < (1ull << Shift))
+		{
+			return Level0Slots + (Level - 1) * LevelNSlots + (int32)((Tick >> (Shift - LevelNBits)) & (LevelNSlots - 1));
+		}
+	}
+	return OverflowSlot;
+}
+
+void FDelayTimingWheel::Link(int32 Id, int32 Slot)
+{
+	FLink& Entry = Links[Id];
+	Entry.Slot = Slot;
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = Heads[Slot];
+	if (Entry.Next != INDEX_NONE)
+	{
+		Links[Entry.Next].Prev = Id;
+	}
+	Heads[Slot] = Id;
+	if (Slot != OverflowSlot)
+	{
+		Occupied[Slot >> 6] |= 1ull << (Slot & 63);
+	}
+}
+
+void FDelayTimingWheel::Unlink(int32 Id)
+{
+	FLink& Entry = Links[Id];
+	if (Entry.Prev != INDEX_NONE)
+	{
+		Links[Entry.Prev].Next = Entry.Next;
+	}
+	else
+	{
+		Heads[Entry.Slot] = Entry.Next;
+		if (Entry.Next == INDEX_NONE && Entry.Slot != OverflowSlot)
+		{
+			Occupied[Entry.Slot >> 6] &= ~(1ull << (Entry.Slot & 63));
+		}
+	}
+	if (Entry.Next != INDEX_NONE)
+	{
+		Links[Entry.Next].Prev = Entry.Prev;
+	}
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = INDEX_NONE;
+	Entry.Slot = INDEX_NONE;
+}
+
+void FDelayTimingWheel::Cascade(int32 Slot)
+{
+	CascadeScratch.Reset();
+	while (Heads[Slot] != INDEX_NONE)
+	{
+		const int32 Id = Heads[Slot];
+		Unlink(Id);
+		CascadeScratch.Add(Id);
+	}
+
+	//下沉时允许落在当前刻度,当前刻度的槽紧接着会被处理
+	for (const int32 Id : CascadeScratch)
+	{
+		Link(Id, SlotFor(FMath::Max(Links[Id].DeadlineTick, CurrentTick)));
+	}
+}
+
+int32 FDelayTimingWheel::FindOccupied(int32 First, int32 Count, int32 Start) const
+{
+	//First为64的整数倍,每次检查一个字中剩余的位
+	for (int32 Offset = 0; Offset < Count;)
+	{
+		const int32 Index = (Start + Offset) & (Count - 1);
+		const int32 Slot = First + Index;
+		const int32 Span = FMath::Min(64 - (Slot & 63), Count - Index);
+		uint64 Bits = Occupied[Slot >> 6] >> (Slot & 63);
+		if (Span < 64)
+		{
+			Bits &= (1ull << Span) - 1;
+		}
+		if (Bits != 0)
+		{
+			const int32 Found = Offset + (int32)FMath::CountTrailingZeros64(Bits);
+			return Found < Count ? Found : INDEX_NONE;
+		}
+		Offset += Span;
+	}
+	return INDEX_NONE;
+}
+
+uint64 FDelayTimingWheel::GetNextEventTick() const
+{
+	if (NumScheduled == 0)
+	{
+		return MAX_uint64;
+	}
+
+	//第0层的槽对应(CurrentTick, CurrentTick + Level0Slots]中唯一的刻度
+	uint64 NextTick = MAX_uint64;
+	const int32 Offset0 = FindOccupied(0, Level0Slots, (int32)((CurrentTick + 1) & (Level0Slots - 1)));
+	if (Offset0 != INDEX_NONE)
+	{
+		NextTick = CurrentTick + 1 + Offset0;
+	}
+
+	//上层的槽在其块开始的刻度下沉
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		const int32 Shift = Level0Bits + (Level - 1) * LevelNBits;
+		const uint64 Block = (CurrentTick >> Shift) + 1;
+		const int32 Offset = FindOccupied(Level0Slots + (Level - 1) * LevelNSlots, LevelNSlots, (int32)(Block & (LevelNSlots - 1)));
+		if (Offset != INDEX_NONE)
+		{
+			NextTick = FMath::Min(NextTick, (Block + Offset) << Shift);
+		}
+	}
+
+	//溢出链表在最上层转完一圈时下沉
+	if (Heads[OverflowSlot] != INDEX_NONE)
+	{
+		NextTick = FMath::Min(NextTick, ((CurrentTick >> WheelBits) + 1) << WheelBits);
+	}
+	return NextTick;
+}
@@ -9,6 +9,81 @@
 #include "UObject/ObjectPtr.h"
 #include "Containers/Set.h"
 #include "CommonUtilBPLibrary.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+/*
+* 多线程提交延迟的压力测试:多个工作线程同时提交,检查每个回调恰好调用一次
+*/
+struct FAnyThreadStressState
+{
+	TArray<int32> Counts;
+	int32 NumFired = 0;
+};
+
+static void ReportAnyThreadStress(const FAnyThreadStressState& State, bool bTimedOut)
+{
+	int32 Lost = 0;
+	int32 Duplicated = 0;
+	for (const int32 Count : State.Counts)
+	{
+		Lost += Count == 0 ? 1 : 0;
+		Duplicated += Count > 1 ? 1 : 0;
+	}
+
+	if (bTimedOut || Lost > 0 || Duplicated > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("TryDelay AnyThread Stress Failed: %d Callbacks, Lost %d, Duplicated %d"), State.Counts.Num(), Lost, Duplicated);
+		ensureMsgf(false, TEXT("TryDelay AnyThread Stress Failed: Lost %d, Duplicated %d"), Lost, Duplicated);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("TryDelay AnyThread Stress Passed: %d Callbacks"), State.Counts.Num());
+	}
+}
+
+static void RunAnyThreadStress(UWorld* World)
+{
+	constexpr int32 NumTasks = 16;
+	constexpr int32 NumPerTask = 4000;
+	constexpr int32 NumTotal = NumTasks * NumPerTask;
+	TSharedRef<FAnyThreadStressState> State = MakeShared<FAnyThreadStressState>();
+	State->Counts.SetNumZeroed(NumTotal);
+
+	ParallelFor(NumTasks, [World, State](int32 Task)
+		{
+			for (int32 Index = 0; Index < NumPerTask; ++Index)
+			{
+				UTryDelayBPLibrary::DelayLambdaFromAnyThread(World, (Index % 10) * 0.01f, [State](int32 Id)
+					{
+						++State->Counts[Id];
+						++State->NumFired;
+						return true;
+					}, Task * NumPerTask + Index);
+			}
+		});
+
+	//请求在之后的帧才取出,等全部回调到达后再检查,不受卡顿影响
+	UTryDelayBPLibrary::DelayUntil(World, [State]() { return State->NumFired >= NumTotal; }, 0.05f, 0.5f, 30.f,
+		[World, State]()
+		{
+			//再等过最长的延迟时间,重复的调用也已到达
+			UTryDelayBPLibrary::DelayLambda(World, -1, 0.2f, false, [State]()
+				{
+					ReportAnyThreadStress(*State, false);
+					return true;
+				});
+		},
+		[State]()
+		{
+			ReportAnyThreadStress(*State, true);
+		});
+}
+
+static FAutoConsoleCommandWithWorld CVarTryDelayAnyThreadStress(
+	TEXT("TryDelay.Test.AnyThreadStress"),
+	TEXT("Schedule delays from worker threads and verify every callback fires exactly once"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&RunAnyThreadStress));
 
 // Sets default values
 ATestDelayActor::ATestDelayActor()
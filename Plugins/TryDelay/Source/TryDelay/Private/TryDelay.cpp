@@ -2,6 +2,7 @@
 
 #include "TryDelay.h"
 #include "TryDelayBPLibrary.h"
+#include "TryDelaySubsystem.h"
 
 #define LOCTEXT_NAMESPACE "FTryDelayModule"
 
@@ -12,7 +13,7 @@ void FTryDelayModule::StartupModule()
 
 void FTryDelayModule::ShutdownModule()
 {
-	
+	UTryDelaySubsystem::DiscardPendingRequests();
 }
 
 void FTryDelayModule::OnPostWorldInit(UWorld* InWorld, const UWorld::InitializationValues)
@@ -1,39 +1,81 @@
 ﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TryDelayBPLibrary.h"
-#include "DelayAction.h"
+#include "TryDelaySubsystem.h"
 #include "UObject/NoExportTypes.h"
 #include "UObject/SavePackage.h"
 
 int32 UTryDelayBPLibrary::DelayFunctionName(UObject* CallbackTarget, int32 uuid, FName ExecutionFunction, float Duration, bool bRetriggerable/* = false*/)
 {
-	if (UWorld* World = CallbackTarget->GetWorld())
-	{
-		FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
-
-		if (uuid == -1)
-		{
-			uuid = UCommonUtilBPLibrary::GenerateUniqueID();
-		}
-
-		FUFunctionDelayAction<>* DelayAction = LatentActionManager.FindExistingAction<FUFunctionDelayAction<>>(CallbackTarget, uuid);
-		if (DelayAction == nullptr)
-		{
-			LatentActionManager.AddNewAction(CallbackTarget, uuid, new FUFunctionDelayAction(CallbackTarget, Duration, ExecutionFunction));
-		}
-		else
+	return AddOrRetrigger(UTryDelaySubsystem::Get(CallbackTarget), uuid, Duration, bRetriggerable, CallbackTarget, [&]()
 		{
-			if (bRetriggerable)
-			{
-				DelayAction->SetDuration(Duration);
-			}
-		}
-		return uuid;
-	}
-	return -1;
+			return new FUFunctionDelayAction<>(CallbackTarget, ExecutionFunction);
+		});
 }
 
 void UTryDelayBPLibrary::DelayFunctionNameForNextTick(UObject* CallbackTarget, FName ExecutionFunction)
 {
 	UTryDelayBPLibrary::DelayFunctionName(CallbackTarget, -1, ExecutionFunction, 0.f);
 }
+
+bool UTryDelayBPLibrary::CancelDelay(const UObject* WorldContextObject, int32 uuid)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler && Scheduler->CancelDelay(Scheduler->HandleFromUuid(uuid));
+}
+
+int32 UTryDelayBPLibrary::CancelDelaysForOwner(UObject* Owner)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(Owner);
+	return Scheduler ? Scheduler->CancelDelaysForOwner(Owner) : 0;
+}
+
+int32 UTryDelayBPLibrary::PauseDelayGroup(const UObject* WorldContextObject, FName Group)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler ? Scheduler->PauseGroup(Group) : 0;
+}
+
+int32 UTryDelayBPLibrary::ResumeDelayGroup(const UObject* WorldContextObject, FName Group)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler ? Scheduler->ResumeGroup(Group) : 0;
+}
+
+int32 UTryDelayBPLibrary::CancelDelayGroup(const UObject* WorldContextObject, FName Group)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler ? Scheduler->CancelGroup(Group) : 0;
+}
+
+void UTryDelayBPLibrary::SetDelayGroupTimeScale(const UObject* WorldContextObject, FName Group, float TimeScale)
+{
+	if (UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject))
+	{
+		Scheduler->TimeScaleGroup(Group, TimeScale);
+	}
+}
+
+bool UTryDelayBPLibrary::PauseDelay(const UObject* WorldContextObject, int32 uuid)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler && Scheduler->PauseDelay(Scheduler->HandleFromUuid(uuid));
+}
+
+bool UTryDelayBPLibrary::ResumeDelay(const UObject* WorldContextObject, int32 uuid)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler && Scheduler->ResumeDelay(Scheduler->HandleFromUuid(uuid));
+}
+
+float UTryDelayBPLibrary::GetRemainingTime(const UObject* WorldContextObject, int32 uuid)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler ? Scheduler->GetRemainingTime(Scheduler->HandleFromUuid(uuid)) : -1.f;
+}
+
+bool UTryDelayBPLibrary::IsDelayActive(const UObject* WorldContextObject, int32 uuid)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	return Scheduler && Scheduler->IsDelayActive(Scheduler->HandleFromUuid(uuid));
+}
@@ -0,0 +1,1705 @@
+﻿#include "TryDelaySubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Containers/Queue.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include "TryDelayStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Delays"), STAT_TryDelay_DeferredDelays, STATGROUP_TryDelay);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fired Delays"), STAT_TryDelay_FiredDelays, STATGROUP_TryDelay);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Parallel Delays"), STAT_TryDelay_ParallelDelays, STATGROUP_TryDelay);
+DECLARE_CYCLE_STAT(TEXT("Parallel Delays Time"), STAT_TryDelay_ParallelDelaysTime, STATGROUP_TryDelay);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tick Functors"), STAT_TryDelay_TickFunctors, STATGROUP_TryDelay);
+//每帧调用次数的分布,各区间为自上次重置以来累计的帧数
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 0 Fires"), STAT_TryDelay_FireBucket0, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 1 Fire"), STAT_TryDelay_FireBucket1, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 2-3 Fires"), STAT_TryDelay_FireBucket2, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 4-7 Fires"), STAT_TryDelay_FireBucket3, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 8-15 Fires"), STAT_TryDelay_FireBucket4, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 16-31 Fires"), STAT_TryDelay_FireBucket5, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 32-63 Fires"), STAT_TryDelay_FireBucket6, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 64-127 Fires"), STAT_TryDelay_FireBucket7, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 128-255 Fires"), STAT_TryDelay_FireBucket8, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 256-511 Fires"), STAT_TryDelay_FireBucket9, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 512-1023 Fires"), STAT_TryDelay_FireBucket10, STATGROUP_TryDelay);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Frames With 1024+ Fires"), STAT_TryDelay_FireBucket11, STATGROUP_TryDelay);
+static_assert(UTryDelaySubsystem::NumFireBuckets == 12, "TryDelay: add a fire histogram stat for each bucket");
+
+#if STATS
+static const FName& GetFireBucketStat(int32 Bucket)
+{
+	static const FName Stats[UTryDelaySubsystem::NumFireBuckets] =
+	{
+		GET_STATFNAME(STAT_TryDelay_FireBucket0), GET_STATFNAME(STAT_TryDelay_FireBucket1), GET_STATFNAME(STAT_TryDelay_FireBucket2),
+		GET_STATFNAME(STAT_TryDelay_FireBucket3), GET_STATFNAME(STAT_TryDelay_FireBucket4), GET_STATFNAME(STAT_TryDelay_FireBucket5),
+		GET_STATFNAME(STAT_TryDelay_FireBucket6), GET_STATFNAME(STAT_TryDelay_FireBucket7), GET_STATFNAME(STAT_TryDelay_FireBucket8),
+		GET_STATFNAME(STAT_TryDelay_FireBucket9), GET_STATFNAME(STAT_TryDelay_FireBucket10), GET_STATFNAME(STAT_TryDelay_FireBucket11),
+	};
+	return Stats[Bucket];
+}
+#endif
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tick Functors Called"), STAT_TryDelay_TickFunctorsCalled, STATGROUP_TryDelay);
+DECLARE_CYCLE_STAT(TEXT("Tick Functors Time"), STAT_TryDelay_TickFunctorsTime, STATGROUP_TryDelay);
+
+static TAutoConsoleVariable<float> CVarTryDelayFrameBudgetMs(
+	TEXT("TryDelay.FrameBudgetMs"),
+	0.f,
+	TEXT("Per-frame budget in milliseconds for running due TryDelay callbacks, overflow is deferred to the next frame in deadline order, critical delays are never deferred. 0 disables the budget"));
+
+static void LogFireHistogram(UWorld* World)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(World);
+	if (Scheduler == nullptr) return;
+
+	const TStaticArray<uint32, UTryDelaySubsystem::NumFireBuckets>& Histogram = Scheduler->GetFireHistogram();
+	UE_LOG(LogTemp, Log, TEXT("TryDelay Fires Per Frame [0]: %u Frames"), Histogram[0]);
+	for (int32 Bucket = 1; Bucket < UTryDelaySubsystem::NumFireBuckets - 1; ++Bucket)
+	{
+		UE_LOG(LogTemp, Log, TEXT("TryDelay Fires Per Frame [%d-%d]: %u Frames"), 1 << (Bucket - 1), (1 << Bucket) - 1, Histogram[Bucket]);
+	}
+	//最后一个区间包含更多的调用次数
+	UE_LOG(LogTemp, Log, TEXT("TryDelay Fires Per Frame [%d+]: %u Frames"), 1 << (UTryDelaySubsystem::NumFireBuckets - 2), Histogram[UTryDelaySubsystem::NumFireBuckets - 1]);
+	Scheduler->ResetFireHistogram();
+}
+
+static FAutoConsoleCommandWithWorld CVarTryDelayFireHistogram(
+	TEXT("TryDelay.FireHistogram"),
+	TEXT("Log how many TryDelay callbacks fired per frame since the last call, then reset the histogram and its stats (stat TryDelay)"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogFireHistogram));
+
+static void FastForwardScheduler(const TArray<FString>& Args, UWorld* World)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(World);
+	if (Scheduler == nullptr || Args.Num() < 1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Usage: TryDelay.FastForward <Seconds> [StepSeconds]"));
+		return;
+	}
+
+	const double Seconds = FCString::Atod(*Args[0]);
+	const float StepSeconds = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.f;
+	const bool bWasSimulating = Scheduler->IsSimulating();
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumFired = Scheduler->FastForward(Seconds, StepSeconds);
+	Scheduler->SetSimulationMode(bWasSimulating);
+	UE_LOG(LogTemp, Log, TEXT("TryDelay Fast Forward %.3fs: %d Delays Fired In %.2fms"), Seconds, NumFired, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CVarTryDelayFastForward(
+	TEXT("TryDelay.FastForward"),
+	TEXT("Advance the TryDelay scheduler by <Seconds> without ticking the world, firing due callbacks in deadline order. Optional [StepSeconds] uses fixed steps, otherwise each step jumps to the next deadline"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&FastForwardScheduler));
+
+namespace TryDelay
+{
+	//时间轮精度,每秒的刻度数
+	static constexpr double TicksPerSecond = 1000.0;
+
+	//帧数时钟的每个刻度为一帧
+	static double TicksPerUnit(EDelayClock Clock)
+	{
+		return Clock == EDelayClock::Frames ? 1.0 : TicksPerSecond;
+	}
+
+	//截止时间及当前时间都向上取整,已过截止时间的定时器一定在当前刻度之内
+	static uint64 CeilToTick(double Time, EDelayClock Clock)
+	{
+		return Time <= 0.0 ? 0 : (uint64)FMath::CeilToDouble(Time * TicksPerUnit(Clock));
+	}
+
+	//小于此周期的延迟只调用一次
+	static constexpr float MinPeriod = 0.0001f;
+}
+
+namespace TryDelay
+{
+	//各世界的调度器,初始化时注册,反初始化时移除
+	static TMap<const UWorld*, UTryDelaySubsystem*> SchedulersByWorld;
+	//可作为默认调度器的游戏世界,按初始化顺序
+	static TArray<UTryDelaySubsystem*> GameSchedulers;
+
+	//其他线程提交的延迟请求
+	struct FDelayRequest
+	{
+		TWeakObjectPtr<const UObject> WorldContext;
+		bool bUseDefault = false;
+		float Duration = 0.f;
+		FDelayActionBase* Action = nullptr;
+	};
+	static TQueue<FDelayRequest, EQueueMode::Mpsc> PendingRequests;
+
+	static const UWorld* LastWorld = nullptr;
+	static UTryDelaySubsystem* LastScheduler = nullptr;
+
+	static bool IsDefaultWorld(const UWorld* World)
+	{
+		#if WITH_EDITOR
+		return World->WorldType == EWorldType::PIE;
+		#else
+		return World->WorldType == EWorldType::Game || World->WorldType == EWorldType::GamePreview;
+		#endif
+	}
+}
+
+void FTryDelayTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Scheduler)
+	{
+		Scheduler->TickInGroup(TickGroup, DeltaTime);
+	}
+}
+
+FString FTryDelayTickFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("FTryDelayTickFunction[%d]"), (int32)TickGroup.GetValue());
+}
+
+UTryDelaySubsystem* UTryDelaySubsystem::Get(const UObject* WorldContextObject)
+{
+	if (WorldContextObject == nullptr)
+	{
+		return nullptr;
+	}
+	if (const UTryDelaySubsystem* Scheduler = Cast<UTryDelaySubsystem>(WorldContextObject))
+	{
+		return const_cast<UTryDelaySubsystem*>(Scheduler);
+	}
+
+	const UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+	if (World != TryDelay::LastWorld)
+	{
+		UTryDelaySubsystem** Scheduler = TryDelay::SchedulersByWorld.Find(World);
+		if (Scheduler == nullptr)
+		{
+			return nullptr;
+		}
+		TryDelay::LastWorld = World;
+		TryDelay::LastScheduler = *Scheduler;
+	}
+	return TryDelay::LastScheduler;
+}
+
+UTryDelaySubsystem* UTryDelaySubsystem::GetDefault()
+{
+	if (TryDelay::GameSchedulers.Num() > 0)
+	{
+		return TryDelay::GameSchedulers[0];
+	}
+	return GWorld ? Get(GWorld->GetWorld()) : nullptr;
+}
+
+void UTryDelaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ResetFireHistogram();
+	OwnerDeleteListener = MakeUnique<FOwnerDeleteListener>(this);
+
+	UWorld* World = GetWorld();
+	check(World);
+	TryDelay::SchedulersByWorld.Add(World, this);
+	if (TryDelay::IsDefaultWorld(World))
+	{
+		TryDelay::GameSchedulers.Add(this);
+	}
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UTryDelaySubsystem::HandleWorldPreActorTick);
+}
+
+void UTryDelaySubsystem::Deinitialize()
+{
+	TryDelay::SchedulersByWorld.Remove(GetWorld());
+	TryDelay::GameSchedulers.Remove(this);
+	TryDelay::LastWorld = nullptr;
+	TryDelay::LastScheduler = nullptr;
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	for (TUniquePtr<FTryDelayTickFunction>& TickFunction : TickFunctions)
+	{
+		if (TickFunction.IsValid())
+		{
+			TickFunction->UnRegisterTickFunction();
+			TickFunction.Reset();
+		}
+	}
+
+	//动作的析构中可能兑现TFuture,其后续添加的延迟直接销毁,不再加入调度器
+	bDeinitialized = true;
+
+	//先移出再销毁,动作的析构中可能访问调度器
+	TArray<FDelayTimer> ReleasedTimers = MoveTemp(Timers);
+	Timers.Reset();
+	FreeTimers.Reset();
+	FreeTimersHead = 0;
+	PendingFreeTimers.Reset();
+	OwnerHeads.Reset();
+	OrphanedTimers.Reset();
+	OwnerDeleteListener.Reset();
+	Groups.Reset();
+	for (FDelayTimer& Timer : ReleasedTimers)
+	{
+		delete Timer.Action;
+		Timer.Action = nullptr;
+	}
+	TMap<FName, FKeyedEntry> ReleasedKeyed = MoveTemp(KeyedEntries);
+	KeyedEntries.Reset();
+	for (TPair<FName, FKeyedEntry>& Pair : ReleasedKeyed)
+	{
+		delete Pair.Value.Pending;
+	}
+	TArray<FChainNode> ReleasedNodes = MoveTemp(ChainNodes);
+	ChainNodes.Reset();
+	FreeChainNodes.Reset();
+	Chains.Reset();
+	FreeChains.Reset();
+	for (FChainNode& Node : ReleasedNodes)
+	{
+		delete Node.Action;
+	}
+	for (auto& ClockBuckets : Buckets)
+	{
+		for (TUniquePtr<FDelayBucket>& Bucket : ClockBuckets)
+		{
+			Bucket.Reset();
+		}
+	}
+
+	FTickableList ReleasedTickables = MoveTemp(Tickables);
+	FTickableList ReleasedPendingTickables = MoveTemp(PendingTickables);
+	Tickables = FTickableList();
+	PendingTickables = FTickableList();
+	for (FTickableActionBase* Action : ReleasedTickables.Actions)
+	{
+		delete Action;
+	}
+	for (FTickableActionBase* Action : ReleasedPendingTickables.Actions)
+	{
+		delete Action;
+	}
+
+	Super::Deinitialize();
+}
+
+void UTryDelaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//初始化期间添加的Tick组延迟,关卡就绪后再注册
+	for (int32 TickGroup = 0; TickGroup < NumTickGroups; ++TickGroup)
+	{
+		RegisterTickFunction(TickGroup);
+	}
+}
+
+void UTryDelaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (bSimulating) return;
+
+	if (!bWorldPaused)
+	{
+		TickFunctors(DeltaTime);
+	}
+	DispatchDueTimers(DefaultTickGroup);
+
+	//调度器Tick在所有Tick组之后,此时本帧的调用已全部完成
+	EndFrame();
+}
+
+void UTryDelaySubsystem::EndFrame()
+{
+	INC_DWORD_STAT_BY(STAT_TryDelay_FiredDelays, NumFiredThisFrame);
+	const int32 Bucket = NumFiredThisFrame == 0 ? 0 : FMath::Min<int32>(FMath::FloorLog2(NumFiredThisFrame) + 1, NumFireBuckets - 1);
+	++FireHistogram[Bucket];
+#if STATS
+	INC_DWORD_STAT_FNAME_BY(GetFireBucketStat(Bucket), 1);
+#endif
+	NumFiredThisFrame = 0;
+}
+
+void UTryDelaySubsystem::ResetFireHistogram()
+{
+	for (int32 Bucket = 0; Bucket < NumFireBuckets; ++Bucket)
+	{
+		FireHistogram[Bucket] = 0;
+#if STATS
+		SET_DWORD_STAT_FNAME(GetFireBucketStat(Bucket), 0);
+#endif
+	}
+}
+
+void UTryDelaySubsystem::HandleWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	//在所有Tick组之前推进时间,本帧添加的延迟与Tick的顺序无关
+	if (InWorld == GetWorld() && !bSimulating)
+	{
+		BeginFrame(DeltaTime);
+	}
+}
+
+void UTryDelaySubsystem::BeginFrame(float DeltaTime)
+{
+	DrainPendingRequests();
+	ReleaseOrphanedTimers();
+
+	bWorldPaused = GetWorld()->IsPaused();
+	if (!bWorldPaused)
+	{
+		CurrentTime += DeltaTime;
+		++FrameCount;
+	}
+	FrameDispatchSeconds = 0.0;
+}
+
+void UTryDelaySubsystem::TickInGroup(int32 TickGroup, float DeltaTime)
+{
+	if (bSimulating) return;
+
+	DispatchDueTimers(TickGroup);
+}
+
+TStatId UTryDelaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTryDelaySubsystem, STATGROUP_Tickables);
+}
+
+FDelayHandle UTryDelaySubsystem::AddDelay(float Duration, FDelayActionBase* Action, const FDelayOptions& Options)
+{
+	check(Action);
+	if (bDeinitialized)
+	{
+		delete Action;
+		return FDelayHandle();
+	}
+
+	const int32 Index = AllocateTimer();
+	checkf((uint32)Index <= FDelayHandle::MaxIndex, TEXT("Too Many Delays"));
+
+	const int32 TickGroup = Options.TickGroup < TG_NewlySpawned ? (int32)Options.TickGroup : DefaultTickGroup;
+	GetBucket(TickGroup, Options.Clock);
+
+	const double Now = GetClockTime(Options.Clock);
+	FDelayTimer& Timer = Timers[Index];
+	Timer.Action = Action;
+	Timer.Deadline = Now + Duration;
+	Timer.Period = Duration;
+	Timer.CatchUp = Options.CatchUp;
+	Timer.Priority = Options.Priority;
+	Timer.Clock = Options.Clock;
+	Timer.TickGroup = (uint8)TickGroup;
+	Timer.bThreadSafe = Options.bThreadSafe;
+
+	if (Options.Owner)
+	{
+		LinkOwner(Index, Options.Owner);
+	}
+	if (!Options.Group.IsNone())
+	{
+		LinkGroup(Index, Options.Group);
+		Timer.Deadline = Now + Duration / Timer.TimeScale;
+	}
+
+	const FDelayHandle Handle(Index, Timer.Generation);
+	if (Options.bSpreadPhase && Duration >= TryDelay::MinPeriod)
+	{
+		//斐波那契散列,连续的句柄落在周期中相距最远的位置
+		const double Phase = (uint32)(GetTypeHash(Handle) * 2654435769u) / 4294967296.0;
+		Timer.Deadline = Now + Duration / Timer.TimeScale * (1.0 - Phase);
+	}
+
+	ScheduleTimer(Index);
+
+	const FDelayGroup* Group = Options.Group.IsNone() ? nullptr : Groups.Find(Options.Group);
+	if (Group && Group->bPaused)
+	{
+		PauseDelay(Handle);
+	}
+	return Handle;
+}
+
+bool UTryDelaySubsystem::RetriggerDelay(FDelayHandle Handle, float Duration)
+{
+	if (FDelayTimer* Timer = FindTimer(Handle))
+	{
+		if (Timer->bPaused)
+		{
+			Timer->Remaining = Duration / Timer->TimeScale;
+		}
+		else
+		{
+			Timer->Deadline = GetClockTime(Timer->Clock) + Duration / Timer->TimeScale;
+			ScheduleTimer(Handle.GetIndex());
+		}
+		return true;
+	}
+	return false;
+}
+
+FDelayHandle UTryDelaySubsystem::HandleFromUuid(int32 uuid) const
+{
+	uint32 Index = 0;
+	uint32 UuidGeneration = 0;
+	if (!FDelayHandle::SplitUuid(uuid, Index, UuidGeneration) || !Timers.IsValidIndex(Index))
+	{
+		return FDelayHandle();
+	}
+
+	const FDelayTimer& Timer = Timers[Index];
+	if (Timer.Action == nullptr || FDelayHandle::ToUuidGeneration(Timer.Generation) != UuidGeneration)
+	{
+		return FDelayHandle();
+	}
+	return FDelayHandle(Index, Timer.Generation);
+}
+
+bool UTryDelaySubsystem::HasDelay(FDelayHandle Handle) const
+{
+	return FindTimer(Handle) != nullptr;
+}
+
+bool UTryDelaySubsystem::CancelDelay(FDelayHandle Handle)
+{
+	if (FindTimer(Handle))
+	{
+		CancelTimer(Handle.GetIndex());
+		return true;
+	}
+	return false;
+}
+
+int32 UTryDelaySubsystem::CancelDelaysForOwner(const UObject* Owner)
+{
+	return Owner ? CancelOwner(GUObjectArray.ObjectToIndex(Owner)) : 0;
+}
+
+int32 UTryDelaySubsystem::PauseGroup(FName Group)
+{
+	if (Group.IsNone()) return 0;
+
+	FDelayGroup& DelayGroup = Groups.FindOrAdd(Group);
+	DelayGroup.bPaused = true;
+
+	int32 NumDelays = 0;
+	for (int32 Index = DelayGroup.Head; Index != INDEX_NONE; Index = Timers[Index].GroupLink.Next)
+	{
+		PauseDelay(FDelayHandle(Index, Timers[Index].Generation));
+		++NumDelays;
+	}
+	return NumDelays;
+}
+
+int32 UTryDelaySubsystem::ResumeGroup(FName Group)
+{
+	FDelayGroup* DelayGroup = Groups.Find(Group);
+	if (DelayGroup == nullptr) return 0;
+
+	DelayGroup->bPaused = false;
+
+	int32 NumDelays = 0;
+	for (int32 Index = DelayGroup->Head; Index != INDEX_NONE; Index = Timers[Index].GroupLink.Next)
+	{
+		ResumeDelay(FDelayHandle(Index, Timers[Index].Generation));
+		++NumDelays;
+	}
+	TrimGroup(Group);
+	return NumDelays;
+}
+
+int32 UTryDelaySubsystem::CancelGroup(FName Group)
+{
+	FDelayGroup* DelayGroup = Groups.Find(Group);
+	if (DelayGroup == nullptr) return 0;
+
+	//先收集句柄,动作的析构中可能取消或添加延迟并复用释放的位置
+	TArray<FDelayHandle, TInlineAllocator<16>> Handles;
+	for (int32 Index = DelayGroup->Head; Index != INDEX_NONE; Index = Timers[Index].GroupLink.Next)
+	{
+		Handles.Add(FDelayHandle(Index, Timers[Index].Generation));
+	}
+	return CancelTimers(Handles);
+}
+
+void UTryDelaySubsystem::TimeScaleGroup(FName Group, float TimeScale)
+{
+	if (Group.IsNone() || !ensureMsgf(TimeScale > 0.f, TEXT("TryDelay Group TimeScale Must Be Positive"))) return;
+
+	FDelayGroup& DelayGroup = Groups.FindOrAdd(Group);
+	DelayGroup.TimeScale = TimeScale;
+	for (int32 Index = DelayGroup.Head; Index != INDEX_NONE; Index = Timers[Index].GroupLink.Next)
+	{
+		FDelayTimer& Timer = Timers[Index];
+		const float Ratio = Timer.TimeScale / TimeScale;
+		Timer.TimeScale = TimeScale;
+		if (Timer.bPaused)
+		{
+			Timer.Remaining *= Ratio;
+		}
+		else if (!Timer.bExecuting && !Timer.bDeferred && !Timer.bPendingCancel)
+		{
+			//执行中的由派发流程按新的缩放累加周期
+			const double Now = GetClockTime(Timer.Clock);
+			Timer.Deadline = Now + FMath::Max(0.0, Timer.Deadline - Now) * Ratio;
+			ScheduleTimer(Index);
+		}
+	}
+	TrimGroup(Group);
+}
+
+float UTryDelaySubsystem::GetGroupTimeScale(FName Group) const
+{
+	const FDelayGroup* DelayGroup = Groups.Find(Group);
+	return DelayGroup ? DelayGroup->TimeScale : 1.f;
+}
+
+bool UTryDelaySubsystem::CancelKeyed(FName Key)
+{
+	FKeyedEntry Entry;
+	if (!KeyedEntries.RemoveAndCopyValue(Key, Entry))
+	{
+		return false;
+	}
+	CancelDelay(Entry.Window);
+	delete Entry.Pending;
+	return true;
+}
+
+bool UTryDelaySubsystem::IsKeyedActive(FName Key) const
+{
+	const FKeyedEntry* Entry = KeyedEntries.Find(Key);
+	return Entry && HasDelay(Entry->Window);
+}
+
+UTryDelaySubsystem::EKeyedCall UTryDelaySubsystem::ArmKeyed(FName Key, float Window, bool bDebounce, EDelayEdge Edge)
+{
+	if (bDeinitialized)
+	{
+		return EKeyedCall::Discard;
+	}
+
+	FKeyedEntry& Entry = KeyedEntries.FindOrAdd(Key);
+	if (HasDelay(Entry.Window))
+	{
+		//窗口中的调用,防抖时推迟窗口
+		if (Entry.bDebounce)
+		{
+			RetriggerDelay(Entry.Window, Window);
+		}
+		return Edge == EDelayEdge::Leading ? EKeyedCall::Discard : EKeyedCall::SetPending;
+	}
+
+	//新的窗口
+	delete Entry.Pending;
+	Entry.Pending = nullptr;
+	Entry.bDebounce = bDebounce;
+	auto OnWindowEnd = [this, Key]()
+	{
+		FinishKeyed(Key);
+		return true;
+	};
+	Entry.Window = AddDelay(Window, new FLambdaDelayAction<decltype(OnWindowEnd)>(MoveTemp(OnWindowEnd)));
+	return Edge == EDelayEdge::Trailing ? EKeyedCall::SetPending : EKeyedCall::FireNow;
+}
+
+void UTryDelaySubsystem::SetKeyedPending(FName Key, FDelayActionBase* Action)
+{
+	//同一尺寸的动作由池复用,替换不会分配堆内存
+	FKeyedEntry& Entry = KeyedEntries.FindChecked(Key);
+	delete Entry.Pending;
+	Entry.Pending = Action;
+}
+
+void UTryDelaySubsystem::FinishKeyed(FName Key)
+{
+	//先移除,函数中可以再次对同一Key防抖或节流
+	FKeyedEntry Entry;
+	if (KeyedEntries.RemoveAndCopyValue(Key, Entry) && Entry.Pending)
+	{
+		Entry.Pending->Execute(FDelayFireInfo());
+		delete Entry.Pending;
+	}
+}
+
+FDelayChainHandle UTryDelaySubsystem::StartChain(float Duration, FDelayActionBase* Action)
+{
+	if (bDeinitialized)
+	{
+		delete Action;
+		return FDelayChainHandle();
+	}
+
+	const int32 ChainIndex = FreeChains.Num() > 0 ? FreeChains.Pop(false) : Chains.AddDefaulted();
+	const FDelayHandle Chain(ChainIndex, Chains[ChainIndex].Generation);
+	const FDelayHandle Root = AddChainNode(Chain, Duration, Action);
+	StartChainNode(Root.GetIndex(), false);
+	return FDelayChainHandle(this, Root, Chain);
+}
+
+FDelayChainHandle UTryDelaySubsystem::ThenChain(const FDelayChainHandle& After, float Duration, FDelayActionBase* Action)
+{
+	if (After.Scheduler.Get() != this || FindChain(After.Chain) == nullptr)
+	{
+		delete Action;
+		return FDelayChainHandle();
+	}
+
+	const FDelayHandle Node = AddChainNode(After.Chain, Duration, Action);
+	if (FChainNode* Prev = FindChainNode(After.Node))
+	{
+		Prev->Successors.Add(Node);
+		ChainNodes[Node.GetIndex()].NumPending = 1;
+	}
+	else
+	{
+		//任务图未结束而节点已释放,说明节点已完成
+		StartChainNode(Node.GetIndex(), false);
+	}
+	return FDelayChainHandle(this, Node, After.Chain);
+}
+
+FDelayChainHandle UTryDelaySubsystem::WhenAll(TArrayView<const FDelayChainHandle> Nodes)
+{
+	return JoinChain(Nodes, false);
+}
+
+FDelayChainHandle UTryDelaySubsystem::WhenAny(TArrayView<const FDelayChainHandle> Nodes)
+{
+	return JoinChain(Nodes, true);
+}
+
+int32 UTryDelaySubsystem::CancelChain(const FDelayChainHandle& Handle)
+{
+	if (Handle.Scheduler.Get() != this || FindChain(Handle.Chain) == nullptr)
+	{
+		return 0;
+	}
+	return CancelChainAt(Handle.Chain.GetIndex());
+}
+
+bool UTryDelaySubsystem::IsChainActive(const FDelayChainHandle& Handle) const
+{
+	return Handle.Scheduler.Get() == this && FindChain(Handle.Chain) != nullptr;
+}
+
+UTryDelaySubsystem::FChainNode* UTryDelaySubsystem::FindChainNode(FDelayHandle Handle)
+{
+	const int32 Index = (int32)Handle.GetIndex();
+	if (Handle.IsValid() && ChainNodes.IsValidIndex(Index))
+	{
+		FChainNode& Node = ChainNodes[Index];
+		if (Node.Generation == Handle.GetGeneration() && !Node.bPendingCancel)
+		{
+			return &Node;
+		}
+	}
+	return nullptr;
+}
+
+const UTryDelaySubsystem::FDelayChain* UTryDelaySubsystem::FindChain(FDelayHandle Handle) const
+{
+	const int32 Index = (int32)Handle.GetIndex();
+	if (Handle.IsValid() && Chains.IsValidIndex(Index) && Chains[Index].Generation == Handle.GetGeneration() && Chains[Index].Head != INDEX_NONE)
+	{
+		return &Chains[Index];
+	}
+	return nullptr;
+}
+
+FDelayHandle UTryDelaySubsystem::AddChainNode(FDelayHandle Chain, float Duration, FDelayActionBase* Action)
+{
+	const int32 Index = FreeChainNodes.Num() > 0 ? FreeChainNodes.Pop(false) : ChainNodes.AddDefaulted();
+	checkf((uint32)Index <= FDelayHandle::MaxIndex, TEXT("Too Many Chain Nodes"));
+
+	FChainNode& Node = ChainNodes[Index];
+	Node.Action = Action;
+	Node.Duration = Duration;
+	Node.Chain = (int32)Chain.GetIndex();
+
+	FDelayChain& DelayChain = Chains[Node.Chain];
+	Node.ChainLink.Next = DelayChain.Head;
+	if (DelayChain.Head != INDEX_NONE)
+	{
+		ChainNodes[DelayChain.Head].ChainLink.Prev = Index;
+	}
+	DelayChain.Head = Index;
+	return FDelayHandle(Index, Node.Generation);
+}
+
+FDelayChainHandle UTryDelaySubsystem::JoinChain(TArrayView<const FDelayChainHandle> Nodes, bool bAny)
+{
+	FDelayHandle Chain;
+	for (const FDelayChainHandle& Node : Nodes)
+	{
+		if (Node.Scheduler.Get() == this && FindChain(Node.Chain))
+		{
+			Chain = Node.Chain;
+			break;
+		}
+	}
+	if (!Chain.IsValid())
+	{
+		return FDelayChainHandle();
+	}
+
+	const FDelayHandle Join = AddChainNode(Chain, 0.f, nullptr);
+	int32 NumLive = 0;
+	int32 NumDone = 0;
+	for (const FDelayChainHandle& Node : Nodes)
+	{
+		if (Node.Scheduler.Get() != this || FindChain(Node.Chain) == nullptr)
+		{
+			//已结束或已取消的任务图
+			continue;
+		}
+		if (FChainNode* Dep = FindChainNode(Node.Node))
+		{
+			Dep->Successors.Add(Join);
+			++NumLive;
+		}
+		else
+		{
+			++NumDone;
+		}
+	}
+
+	FChainNode& JoinNode = ChainNodes[Join.GetIndex()];
+	JoinNode.bAny = bAny;
+	JoinNode.NumPending = NumLive;
+	if (NumLive == 0 || (bAny && NumDone > 0))
+	{
+		StartChainNode(Join.GetIndex(), false);
+	}
+	return FDelayChainHandle(this, Join, Chain);
+}
+
+void UTryDelaySubsystem::StartChainNode(int32 Index, bool bInline)
+{
+	FChainNode& Node = ChainNodes[Index];
+	Node.bStarted = true;
+	if (bInline && Node.Duration <= 0.f)
+	{
+		CompleteChainNode(Index);
+		return;
+	}
+
+	const FDelayHandle Handle(Index, Node.Generation);
+	auto OnElapsed = [this, Handle]()
+	{
+		if (FindChainNode(Handle))
+		{
+			CompleteChainNode(Handle.GetIndex());
+		}
+		return true;
+	};
+	Node.Timer = AddDelay(Node.Duration, new FLambdaDelayAction<decltype(OnElapsed)>(MoveTemp(OnElapsed)));
+}
+
+void UTryDelaySubsystem::CompleteChainNode(int32 Index)
+{
+	ChainNodes[Index].Timer = FDelayHandle();
+	if (FDelayActionBase* Action = ChainNodes[Index].Action)
+	{
+		//回调中可能添加新的节点,调用后不能再使用之前的引用
+		ChainNodes[Index].Action = nullptr;
+		ChainNodes[Index].bExecuting = true;
+		Action->Execute(FDelayFireInfo());
+		delete Action;
+		ChainNodes[Index].bExecuting = false;
+	}
+
+	FChainNode& Node = ChainNodes[Index];
+	if (Node.bPendingCancel)
+	{
+		ReleaseChainNode(Index);
+		return;
+	}
+
+	TArray<FDelayHandle, TInlineAllocator<2>> Successors = MoveTemp(Node.Successors);
+	ReleaseChainNode(Index);
+	for (const FDelayHandle& Successor : Successors)
+	{
+		FChainNode* Next = FindChainNode(Successor);
+		if (Next && !Next->bStarted && (Next->bAny || --Next->NumPending == 0))
+		{
+			StartChainNode(Successor.GetIndex(), true);
+		}
+	}
+}
+
+void UTryDelaySubsystem::CancelChainNode(int32 Index)
+{
+	FChainNode& Node = ChainNodes[Index];
+	const int32 ChainIndex = Node.Chain;
+	CancelDelay(Node.Timer);
+	TArray<FDelayHandle, TInlineAllocator<2>> Successors = MoveTemp(Node.Successors);
+	if (Node.bExecuting)
+	{
+		//正在执行的节点执行结束后释放,先移出任务图
+		Node.bPendingCancel = true;
+		UnlinkChainNode(Index);
+	}
+	else
+	{
+		ReleaseChainNode(Index);
+	}
+
+	//同一任务图的节点由CancelChainAt取消,其它任务图中依赖本节点的节点无法再完成
+	for (const FDelayHandle& Successor : Successors)
+	{
+		FChainNode* Next = FindChainNode(Successor);
+		if (Next == nullptr || Next->Chain == ChainIndex || Next->bStarted)
+		{
+			continue;
+		}
+		if (!Next->bAny || --Next->NumPending == 0)
+		{
+			CancelChainAt(Next->Chain);
+		}
+	}
+}
+
+int32 UTryDelaySubsystem::CancelChainAt(int32 ChainIndex)
+{
+	//先收集节点,取消时会修改链表
+	TArray<FDelayHandle, TInlineAllocator<16>> Nodes;
+	for (int32 Index = Chains[ChainIndex].Head; Index != INDEX_NONE; Index = ChainNodes[Index].ChainLink.Next)
+	{
+		Nodes.Add(FDelayHandle(Index, ChainNodes[Index].Generation));
+	}
+
+	int32 NumCancelled = 0;
+	for (const FDelayHandle& Node : Nodes)
+	{
+		if (FindChainNode(Node))
+		{
+			CancelChainNode(Node.GetIndex());
+			++NumCancelled;
+		}
+	}
+	return NumCancelled;
+}
+
+void UTryDelaySubsystem::UnlinkChainNode(int32 Index)
+{
+	FChainNode& Node = ChainNodes[Index];
+	if (Node.Chain == INDEX_NONE) return;
+
+	FDelayChain& Chain = Chains[Node.Chain];
+	if (Node.ChainLink.Prev != INDEX_NONE)
+	{
+		ChainNodes[Node.ChainLink.Prev].ChainLink.Next = Node.ChainLink.Next;
+	}
+	else
+	{
+		Chain.Head = Node.ChainLink.Next;
+	}
+	if (Node.ChainLink.Next != INDEX_NONE)
+	{
+		ChainNodes[Node.ChainLink.Next].ChainLink.Prev = Node.ChainLink.Prev;
+	}
+
+	//最后一个节点结束时释放任务图,旧句柄随即失效
+	if (Chain.Head == INDEX_NONE)
+	{
+		Chain.Generation = FDelayHandle::NextGeneration(Chain.Generation);
+		FreeChains.Add(Node.Chain);
+	}
+	Node.Chain = INDEX_NONE;
+	Node.ChainLink = FTimerLink();
+}
+
+void UTryDelaySubsystem::ReleaseChainNode(int32 Index)
+{
+	UnlinkChainNode(Index);
+	FChainNode& Node = ChainNodes[Index];
+	delete Node.Action;
+	const uint32 Generation = FDelayHandle::NextGeneration(Node.Generation);
+	Node = FChainNode();
+	Node.Generation = Generation;
+	FreeChainNodes.Add(Index);
+}
+
+bool UTryDelaySubsystem::PauseDelay(FDelayHandle Handle)
+{
+	if (FDelayTimer* Timer = FindTimer(Handle))
+	{
+		if (!Timer->bPaused)
+		{
+			Timer->bPaused = true;
+			Timer->Remaining = FMath::Max(0.f, (float)(Timer->Deadline - GetClockTime(Timer->Clock)));
+			GetWheel(*Timer).Cancel(Handle.GetIndex());
+		}
+		return true;
+	}
+	return false;
+}
+
+bool UTryDelaySubsystem::ResumeDelay(FDelayHandle Handle)
+{
+	if (FDelayTimer* Timer = FindTimer(Handle))
+	{
+		if (Timer->bPaused)
+		{
+			Timer->bPaused = false;
+			Timer->Deadline = GetClockTime(Timer->Clock) + Timer->Remaining;
+			//执行中暂停又恢复的,由派发流程决定是否重新放入时间轮
+			if (!Timer->bExecuting)
+			{
+				ScheduleTimer(Handle.GetIndex());
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+float UTryDelaySubsystem::GetRemainingTime(FDelayHandle Handle) const
+{
+	if (const FDelayTimer* Timer = FindTimer(Handle))
+	{
+		return Timer->bPaused ? Timer->Remaining : FMath::Max(0.f, (float)(Timer->Deadline - GetClockTime(Timer->Clock)));
+	}
+	return -1.f;
+}
+
+double UTryDelaySubsystem::GetClockTime(EDelayClock Clock) const
+{
+	if (bSimulating && Clock != EDelayClock::Frames)
+	{
+		return CurrentTime + SimulationOffsets[(int32)Clock];
+	}
+
+	return GetWorldClockTime(Clock) + ClockOffsets[(int32)Clock];
+}
+
+double UTryDelaySubsystem::GetWorldClockTime(EDelayClock Clock) const
+{
+	const UWorld* World = GetWorld();
+	switch (Clock)
+	{
+	case EDelayClock::Frames:
+		return (double)FrameCount;
+	case EDelayClock::Real:
+		return World ? World->GetRealTimeSeconds() : 0.0;
+	case EDelayClock::Audio:
+		return World ? World->GetAudioTimeSeconds() : 0.0;
+	case EDelayClock::Unpaused:
+		return World ? World->GetUnpausedTimeSeconds() : 0.0;
+	default:
+		return CurrentTime;
+	}
+}
+
+void UTryDelaySubsystem::SetSimulationMode(bool bEnable)
+{
+	if (bSimulating == bEnable) return;
+
+	if (bEnable)
+	{
+		for (int32 Clock = 0; Clock < NumClocks; ++Clock)
+		{
+			SimulationOffsets[Clock] = GetClockTime((EDelayClock)Clock) - CurrentTime;
+		}
+	}
+	else
+	{
+		//时间轮不会后退,从模拟结束时的值继续前进
+		for (int32 Clock = 0; Clock < NumClocks; ++Clock)
+		{
+			if (Clock != (int32)EDelayClock::Frames)
+			{
+				ClockOffsets[Clock] = CurrentTime + SimulationOffsets[Clock] - GetWorldClockTime((EDelayClock)Clock);
+			}
+		}
+	}
+	bSimulating = bEnable;
+}
+
+int32 UTryDelaySubsystem::FastForward(double Seconds, float StepSeconds)
+{
+	checkf(!bDispatching && !bTickingFunctors, TEXT("FastForward Cannot Be Called From A Delay Callback"));
+
+	SetSimulationMode(true);
+	DrainPendingRequests();
+	ReleaseOrphanedTimers();
+
+	const double EndTime = CurrentTime + Seconds;
+	int32 NumFired = 0;
+	while (CurrentTime < EndTime)
+	{
+		double StepEnd = StepSeconds > 0.f ? CurrentTime + StepSeconds : GetNextSimulatedDeadline();
+		//换算误差可能使截止时间不晚于当前时间,每步至少前进半个刻度
+		StepEnd = FMath::Min(FMath::Max(StepEnd, CurrentTime + 0.5 / TryDelay::TicksPerSecond), EndTime);
+		NumFired += SimulateStep(StepEnd);
+	}
+	return NumFired;
+}
+
+int32 UTryDelaySubsystem::SimulateStep(double NewTime)
+{
+	const float DeltaTime = (float)(NewTime - CurrentTime);
+	CurrentTime = NewTime;
+	++FrameCount;
+	bWorldPaused = false;
+	FrameDispatchSeconds = 0.0;
+
+	TickFunctors(DeltaTime);
+	for (int32 TickGroup = 0; TickGroup < NumTickGroups; ++TickGroup)
+	{
+		DispatchDueTimers(TickGroup);
+	}
+
+	const int32 NumFired = (int32)NumFiredThisFrame;
+	EndFrame();
+	return NumFired;
+}
+
+double UTryDelaySubsystem::GetNextSimulatedDeadline() const
+{
+	double Next = MAX_dbl;
+	for (int32 TickGroup = 0; TickGroup < NumTickGroups; ++TickGroup)
+	{
+		for (int32 Clock = 0; Clock < NumClocks; ++Clock)
+		{
+			//Frames时钟每步加1,不决定步长
+			const FDelayBucket* Bucket = Buckets[TickGroup][Clock].Get();
+			if (Bucket == nullptr || Clock == (int32)EDelayClock::Frames)
+			{
+				continue;
+			}
+			if (Bucket->Deferred.Num() > 0)
+			{
+				return CurrentTime;
+			}
+
+			uint64 Tick = 0;
+			if (Bucket->Wheel.GetNextDeadlineTick(Tick))
+			{
+				Next = FMath::Min(Next, Tick / TryDelay::TicksPerSecond - SimulationOffsets[Clock]);
+			}
+		}
+	}
+	return Next;
+}
+
+bool UTryDelaySubsystem::IsDelayActive(FDelayHandle Handle) const
+{
+	const FDelayTimer* Timer = FindTimer(Handle);
+	return Timer && !Timer->bPaused;
+}
+
+int32 UTryDelaySubsystem::AllocateTimer()
+{
+	if (FreeTimers.Num() - FreeTimersHead <= MinFreeTimers)
+	{
+		return Timers.AddDefaulted();
+	}
+
+	const int32 Index = FreeTimers[FreeTimersHead++];
+	//已取出的部分过半时再整体前移
+	if (FreeTimersHead * 2 >= FreeTimers.Num())
+	{
+		FreeTimers.RemoveAt(0, FreeTimersHead, false);
+		FreeTimersHead = 0;
+	}
+	return Index;
+}
+
+UTryDelaySubsystem::FDelayTimer* UTryDelaySubsystem::FindTimer(FDelayHandle Handle)
+{
+	return const_cast<FDelayTimer*>(static_cast<const UTryDelaySubsystem*>(this)->FindTimer(Handle));
+}
+
+const UTryDelaySubsystem::FDelayTimer* UTryDelaySubsystem::FindTimer(FDelayHandle Handle) const
+{
+	if (!Handle.IsValid() || !Timers.IsValidIndex(Handle.GetIndex()))
+	{
+		return nullptr;
+	}
+	const FDelayTimer& Timer = Timers[Handle.GetIndex()];
+	if (Timer.Generation != Handle.GetGeneration() || Timer.Action == nullptr || Timer.bPendingCancel)
+	{
+		return nullptr;
+	}
+	return &Timer;
+}
+
+void UTryDelaySubsystem::EnqueueDelay(const UObject* WorldContextObject, float Duration, FDelayActionBase* Action)
+{
+	check(Action);
+
+	TryDelay::FDelayRequest Request;
+	Request.WorldContext = WorldContextObject;
+	Request.bUseDefault = WorldContextObject == nullptr;
+	Request.Duration = Duration;
+	Request.Action = Action;
+	TryDelay::PendingRequests.Enqueue(MoveTemp(Request));
+}
+
+void UTryDelaySubsystem::DiscardPendingRequests()
+{
+	check(IsInGameThread());
+
+	TryDelay::FDelayRequest Request;
+	while (TryDelay::PendingRequests.Dequeue(Request))
+	{
+		delete Request.Action;
+	}
+}
+
+void UTryDelaySubsystem::DrainPendingRequests()
+{
+	TryDelay::FDelayRequest Request;
+	while (TryDelay::PendingRequests.Dequeue(Request))
+	{
+		UTryDelaySubsystem* Scheduler = Request.bUseDefault ? GetDefault() : Get(Request.WorldContext.Get());
+		if (Scheduler)
+		{
+			Scheduler->AddDelay(Request.Duration, Request.Action);
+		}
+		else
+		{
+			delete Request.Action;
+		}
+	}
+}
+
+void UTryDelaySubsystem::AddTickable(FTickableActionBase* Action, float Interval)
+{
+	check(Action);
+	if (bDeinitialized)
+	{
+		delete Action;
+	}
+	else if (bTickingFunctors)
+	{
+		PendingTickables.Add(Action, Interval);
+	}
+	else
+	{
+		Tickables.Add(Action, Interval);
+	}
+}
+
+void UTryDelaySubsystem::TickFunctors(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TryDelay_TickFunctorsTime);
+
+	bTickingFunctors = true;
+	int32 NumCalled = 0;
+	for (int32 Index = 0; Index < Tickables.Actions.Num();)
+	{
+		const float Elapsed = Tickables.Elapsed[Index] + DeltaTime;
+		if (Elapsed < Tickables.Intervals[Index])
+		{
+			Tickables.Elapsed[Index] = Elapsed;
+			++Index;
+			continue;
+		}
+
+		Tickables.Elapsed[Index] = 0.f;
+		++NumCalled;
+		if (Tickables.Actions[Index]->Tick(Elapsed))
+		{
+			//与末尾交换,换过来的动作本帧尚未调用,下标不变
+			delete Tickables.Actions[Index];
+			Tickables.RemoveAtSwap(Index);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+	bTickingFunctors = false;
+
+	for (int32 Index = 0; Index < PendingTickables.Actions.Num(); ++Index)
+	{
+		Tickables.Add(PendingTickables.Actions[Index], PendingTickables.Intervals[Index]);
+	}
+	PendingTickables = FTickableList();
+
+	SET_DWORD_STAT(STAT_TryDelay_TickFunctors, Tickables.Actions.Num());
+	INC_DWORD_STAT_BY(STAT_TryDelay_TickFunctorsCalled, NumCalled);
+}
+
+void UTryDelaySubsystem::DispatchDueTimers(int32 TickGroup)
+{
+	//模拟时不受预算限制,结果与机器速度无关
+	const double BudgetSeconds = bSimulating ? 0.0 : CVarTryDelayFrameBudgetMs.GetValueOnGameThread() * 0.001;
+	const double StartTime = FPlatformTime::Seconds();
+
+	bDispatching = true;
+	for (int32 Clock = 0; Clock < NumClocks; ++Clock)
+	{
+		if (FDelayBucket* Bucket = Buckets[TickGroup][Clock].Get())
+		{
+			DispatchBucket(*Bucket, (EDelayClock)Clock, BudgetSeconds > 0.0, StartTime + BudgetSeconds - FrameDispatchSeconds);
+		}
+	}
+	bDispatching = false;
+
+	FreeTimers.Append(PendingFreeTimers);
+	PendingFreeTimers.Reset();
+
+	FrameDispatchSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UTryDelaySubsystem::DispatchBucket(FDelayBucket& Bucket, EDelayClock Clock, bool bUseBudget, double BudgetEndTime)
+{
+	DueTimers.Reset();
+	const double Now = GetClockTime(Clock);
+	Bucket.Wheel.Advance(TryDelay::CeilToTick(Now, Clock), DueTimers);
+
+	//与当前时间同一刻度但尚未到达截止时间的放回时间轮,在之后的帧中调用
+	DueTimers.RemoveAll([this, Now](int32 Index)
+		{
+			if (Timers[Index].Deadline <= Now)
+			{
+				return false;
+			}
+			ScheduleTimer(Index);
+			return true;
+		});
+
+	//上一帧推迟的定时器与本帧到期的一起按截止时间执行
+	for (const FDelayHandle Handle : Bucket.Deferred)
+	{
+		if (FDelayTimer* Timer = FindTimer(Handle))
+		{
+			if (Timer->bDeferred)
+			{
+				Timer->bDeferred = false;
+				DueTimers.Add(Handle.GetIndex());
+			}
+		}
+	}
+	Bucket.Deferred.Reset();
+
+	//时间轮只精确到刻度,同一刻度内按精确的截止时间排序,相同时按下标
+	if (DueTimers.Num() > 1)
+	{
+		DueTimers.Sort([this](int32 A, int32 B)
+			{
+				const double DeadlineA = Timers[A].Deadline;
+				const double DeadlineB = Timers[B].Deadline;
+				return DeadlineA < DeadlineB || (DeadlineA == DeadlineB && A < B);
+			});
+	}
+
+	ParallelActions.Reset();
+	ParallelTimers.Reset();
+	for (const int32 Index : DueTimers)
+	{
+		const FDelayTimer& Timer = Timers[Index];
+		if (Timer.bThreadSafe && Timer.Action && !Timer.bPaused && !Bucket.Wheel.IsScheduled(Index))
+		{
+			if (FParallelDelayActionBase* Action = Timer.Action->AsParallel())
+			{
+				ParallelActions.Add(Action);
+				ParallelTimers.Add(FDelayHandle(Index, Timer.Generation));
+			}
+		}
+	}
+	if (ParallelActions.Num() > 0)
+	{
+		//同一批在工作线程中计算,下面按截止时间在游戏线程应用结果
+		SCOPE_CYCLE_COUNTER(STAT_TryDelay_ParallelDelaysTime);
+		INC_DWORD_STAT_BY(STAT_TryDelay_ParallelDelays, ParallelActions.Num());
+		ParallelFor(ParallelActions.Num(), [this](int32 ActionIndex)
+			{
+				ParallelActions[ActionIndex]->ComputeParallel();
+			});
+	}
+
+	for (const int32 Index : DueTimers)
+	{
+		FDelayTimer& Timer = Timers[Index];
+		//已被之前的回调取消、暂停或重置了时间
+		if (Timer.Action == nullptr || Timer.bPaused || Bucket.Wheel.IsScheduled(Index))
+		{
+			continue;
+		}
+
+		if (bUseBudget && Timer.Priority != EDelayPriority::Critical && FPlatformTime::Seconds() >= BudgetEndTime)
+		{
+			Timer.bDeferred = true;
+			Bucket.Deferred.Add(FDelayHandle(Index, Timer.Generation));
+			continue;
+		}
+		FireTimer(Index);
+	}
+
+	//动作可能已随定时器销毁,通过句柄访问
+	for (const FDelayHandle Handle : ParallelTimers)
+	{
+		if (FDelayTimer* Timer = FindTimer(Handle))
+		{
+			Timer->Action->AsParallel()->DiscardComputed();
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_TryDelay_DeferredDelays, Bucket.Deferred.Num());
+}
+
+void UTryDelaySubsystem::FireTimer(int32 Index)
+{
+	const FDelayTimer& Timer = Timers[Index];
+	const double Now = GetClockTime(Timer.Clock);
+
+	//落后的周期数,包括本次
+	int32 NumPeriods = 1;
+	if (Timer.Period >= TryDelay::MinPeriod && Timer.CatchUp != EDelayCatchUp::Spread)
+	{
+		NumPeriods += FMath::Max(0, (int32)FMath::FloorToDouble((Now - Timer.Deadline) * Timer.TimeScale / Timer.Period));
+	}
+
+	FDelayFireInfo Info;
+	Info.ScheduledTime = Timer.Deadline;
+	Info.Lateness = Now - Timer.Deadline;
+	if (Timer.CatchUp == EDelayCatchUp::FireAll)
+	{
+		bool bRepeat = true;
+		for (int32 Fire = 0; Fire < NumPeriods && bRepeat; ++Fire)
+		{
+			//每次补上的周期使用各自的截止时间
+			Info.ScheduledTime = Timers[Index].Deadline;
+			Info.Lateness = Now - Info.ScheduledTime;
+			bRepeat = ExecuteTimer(Index, Info, 1);
+		}
+		if (bRepeat)
+		{
+			ScheduleTimer(Index);
+		}
+	}
+	else
+	{
+		Info.Count = Timer.CatchUp == EDelayCatchUp::Coalesce ? NumPeriods : 1;
+		if (ExecuteTimer(Index, Info, NumPeriods))
+		{
+			ScheduleTimer(Index);
+		}
+	}
+}
+
+bool UTryDelaySubsystem::ExecuteTimer(int32 Index, const FDelayFireInfo& Info, int32 NumPeriods)
+{
+	//回调中可能添加新的定时器,调用后不能再使用之前的引用
+	FDelayActionBase* Action = Timers[Index].Action;
+	Timers[Index].bExecuting = true;
+	++NumFiredThisFrame;
+	const bool bDone = Action->Execute(Info);
+
+	FDelayTimer& Timer = Timers[Index];
+	Timer.bExecuting = false;
+	if (Timer.bPendingCancel)
+	{
+		ReleaseTimer(Index);
+		return false;
+	}
+	if (GetWheel(Timer).IsScheduled(Index))
+	{
+		//回调中已重置了时间
+		return false;
+	}
+
+	if (bDone || Timer.Period < TryDelay::MinPeriod)
+	{
+		ReleaseTimer(Index);
+		return false;
+	}
+	if (Timer.bPaused)
+	{
+		Timer.Remaining = Timer.Period / Timer.TimeScale;
+		return false;
+	}
+	//按周期累加截止时间,不因帧时间产生漂移
+	Timer.Deadline += Timer.Period / Timer.TimeScale * NumPeriods;
+	return true;
+}
+
+void UTryDelaySubsystem::ScheduleTimer(int32 Index)
+{
+	FDelayTimer& Timer = Timers[Index];
+	Timer.bDeferred = false;
+	GetWheel(Timer).Schedule(Index, TryDelay::CeilToTick(Timer.Deadline, Timer.Clock));
+}
+
+void UTryDelaySubsystem::CancelTimer(int32 Index)
+{
+	FDelayTimer& Timer = Timers[Index];
+	if (Timer.bExecuting)
+	{
+		//正在执行的动作不能立即销毁
+		Timer.bPendingCancel = true;
+		GetWheel(Timer).Cancel(Index);
+	}
+	else
+	{
+		ReleaseTimer(Index);
+	}
+}
+
+int32 UTryDelaySubsystem::CancelTimers(TArrayView<const FDelayHandle> Handles)
+{
+	int32 NumCancelled = 0;
+	for (const FDelayHandle& Handle : Handles)
+	{
+		if (FindTimer(Handle))
+		{
+			CancelTimer(Handle.GetIndex());
+			++NumCancelled;
+		}
+	}
+	return NumCancelled;
+}
+
+void UTryDelaySubsystem::ReleaseTimer(int32 Index)
+{
+	UnlinkOwner(Index);
+	UnlinkGroup(Index);
+	FDelayTimer& Timer = Timers[Index];
+	GetWheel(Timer).Cancel(Index);
+	FDelayActionBase* Action = Timer.Action;
+	const uint32 Generation = FDelayHandle::NextGeneration(Timer.Generation);
+	Timer = FDelayTimer();
+	Timer.Generation = Generation;
+
+	//先销毁再回收位置,析构中可能兑现TFuture并在其后续中添加新的延迟,不能复用本位置
+	delete Action;
+
+	if (bDispatching)
+	{
+		PendingFreeTimers.Add(Index);
+	}
+	else
+	{
+		FreeTimers.Add(Index);
+	}
+}
+
+UTryDelaySubsystem::FDelayBucket& UTryDelaySubsystem::GetBucket(int32 TickGroup, EDelayClock Clock)
+{
+	TUniquePtr<FDelayBucket>& Bucket = Buckets[TickGroup][(int32)Clock];
+	if (!Bucket.IsValid())
+	{
+		Bucket = MakeUnique<FDelayBucket>();
+		//新的时间轮为空,直接跳到时钟的当前刻度
+		TArray<int32> NoneDue;
+		Bucket->Wheel.Advance(TryDelay::CeilToTick(GetClockTime(Clock), Clock), NoneDue);
+		RegisterTickFunction(TickGroup);
+	}
+	return *Bucket;
+}
+
+FDelayTimingWheel& UTryDelaySubsystem::GetWheel(const FDelayTimer& Timer) const
+{
+	return Buckets[Timer.TickGroup][(int32)Timer.Clock]->Wheel;
+}
+
+void UTryDelaySubsystem::RegisterTickFunction(int32 TickGroup)
+{
+	if (TickGroup == DefaultTickGroup)
+	{
+		return;
+	}
+
+	bool bUsed = false;
+	for (const TUniquePtr<FDelayBucket>& Bucket : Buckets[TickGroup])
+	{
+		bUsed |= Bucket.IsValid();
+	}
+	if (!bUsed)
+	{
+		return;
+	}
+
+	TUniquePtr<FTryDelayTickFunction>& TickFunction = TickFunctions[TickGroup];
+	if (!TickFunction.IsValid())
+	{
+		TickFunction = MakeUnique<FTryDelayTickFunction>();
+		TickFunction->Scheduler = this;
+		TickFunction->TickGroup = (ETickingGroup)TickGroup;
+		TickFunction->EndTickGroup = (ETickingGroup)TickGroup;
+		TickFunction->bCanEverTick = true;
+		TickFunction->bTickEvenWhenPaused = true;
+		TickFunction->bStartWithTickEnabled = true;
+	}
+
+	ULevel* Level = GetWorld()->PersistentLevel;
+	if (Level && !TickFunction->IsTickFunctionRegistered())
+	{
+		TickFunction->RegisterTickFunction(Level);
+	}
+}
+
+void UTryDelaySubsystem::LinkTimer(int32 Index, FTimerLink FDelayTimer::* Link, int32& Head)
+{
+	FTimerLink& Node = Timers[Index].*Link;
+	Node.Prev = INDEX_NONE;
+	Node.Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		(Timers[Head].*Link).Prev = Index;
+	}
+	Head = Index;
+}
+
+void UTryDelaySubsystem::UnlinkTimer(int32 Index, FTimerLink FDelayTimer::* Link, int32& Head)
+{
+	FTimerLink& Node = Timers[Index].*Link;
+	if (Node.Prev != INDEX_NONE)
+	{
+		(Timers[Node.Prev].*Link).Next = Node.Next;
+	}
+	else
+	{
+		Head = Node.Next;
+	}
+	if (Node.Next != INDEX_NONE)
+	{
+		(Timers[Node.Next].*Link).Prev = Node.Prev;
+	}
+	Node = FTimerLink();
+}
+
+void UTryDelaySubsystem::LinkOwner(int32 Index, const UObject* Owner)
+{
+	const int32 OwnerIndex = GUObjectArray.ObjectToIndex(Owner);
+	Timers[Index].OwnerIndex = OwnerIndex;
+
+	int32& Head = OwnerHeads.FindOrAdd(OwnerIndex, INDEX_NONE);
+	if (Head == INDEX_NONE)
+	{
+		if (AActor* Actor = const_cast<AActor*>(Cast<AActor>(Owner)))
+		{
+			//所有者的第一个延迟,监听其EndPlay
+			Actor->OnEndPlay.AddUniqueDynamic(this, &UTryDelaySubsystem::HandleOwnerEndPlay);
+		}
+	}
+	LinkTimer(Index, &FDelayTimer::OwnerLink, Head);
+}
+
+void UTryDelaySubsystem::UnlinkOwner(int32 Index)
+{
+	const int32 OwnerIndex = Timers[Index].OwnerIndex;
+	if (OwnerIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	int32& Head = OwnerHeads.FindChecked(OwnerIndex);
+	UnlinkTimer(Index, &FDelayTimer::OwnerLink, Head);
+	if (Head == INDEX_NONE)
+	{
+		OwnerHeads.Remove(OwnerIndex);
+	}
+	Timers[Index].OwnerIndex = INDEX_NONE;
+}
+
+void UTryDelaySubsystem::LinkGroup(int32 Index, FName Group)
+{
+	FDelayGroup& DelayGroup = Groups.FindOrAdd(Group);
+	Timers[Index].Group = Group;
+	Timers[Index].TimeScale = DelayGroup.TimeScale;
+	LinkTimer(Index, &FDelayTimer::GroupLink, DelayGroup.Head);
+}
+
+void UTryDelaySubsystem::UnlinkGroup(int32 Index)
+{
+	const FName Group = Timers[Index].Group;
+	if (Group.IsNone())
+	{
+		return;
+	}
+
+	UnlinkTimer(Index, &FDelayTimer::GroupLink, Groups.FindChecked(Group).Head);
+	Timers[Index].Group = NAME_None;
+	TrimGroup(Group);
+}
+
+void UTryDelaySubsystem::TrimGroup(FName Group)
+{
+	const FDelayGroup* DelayGroup = Groups.Find(Group);
+	if (DelayGroup && DelayGroup->Head == INDEX_NONE && !DelayGroup->bPaused && DelayGroup->TimeScale == 1.f)
+	{
+		Groups.Remove(Group);
+	}
+}
+
+int32 UTryDelaySubsystem::CancelOwner(int32 OwnerIndex)
+{
+	const int32* Head = OwnerHeads.Find(OwnerIndex);
+	if (Head == nullptr)
+	{
+		return 0;
+	}
+
+	//同CancelGroup,先收集句柄
+	TArray<FDelayHandle, TInlineAllocator<16>> Handles;
+	for (int32 Index = *Head; Index != INDEX_NONE; Index = Timers[Index].OwnerLink.Next)
+	{
+		Handles.Add(FDelayHandle(Index, Timers[Index].Generation));
+	}
+	return CancelTimers(Handles);
+}
+
+void UTryDelaySubsystem::HandleOwnerEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	CancelDelaysForOwner(Actor);
+}
+
+void UTryDelaySubsystem::FOwnerDeleteListener::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index)
+{
+	//延迟只在游戏线程上添加,其他线程销毁的对象不会是所有者
+	if (IsInGameThread())
+	{
+		Scheduler->OrphanOwner(Index);
+	}
+}
+
+void UTryDelaySubsystem::OrphanOwner(int32 OwnerIndex)
+{
+	int32 Index = INDEX_NONE;
+	if (!OwnerHeads.RemoveAndCopyValue(OwnerIndex, Index))
+	{
+		return;
+	}
+
+	//垃圾回收中不能调用用户代码,这里只摘除定时器,不销毁动作,遍历时链表不会被修改
+	while (Index != INDEX_NONE)
+	{
+		FDelayTimer& Timer = Timers[Index];
+		const int32 Next = Timer.OwnerLink.Next;
+		Timer.OwnerLink = FTimerLink();
+		Timer.OwnerIndex = INDEX_NONE;
+		if (!Timer.bPendingCancel)
+		{
+			Timer.bPendingCancel = true;
+			GetWheel(Timer).Cancel(Index);
+			UnlinkGroup(Index);
+			//执行中的由派发流程释放
+			if (!Timer.bExecuting)
+			{
+				OrphanedTimers.Add(FDelayHandle(Index, Timer.Generation));
+			}
+		}
+		Index = Next;
+	}
+}
+
+void UTryDelaySubsystem::ReleaseOrphanedTimers()
+{
+	//先移出,销毁动作时可能有新的所有者被销毁
+	TArray<FDelayHandle> Orphans = MoveTemp(OrphanedTimers);
+	OrphanedTimers.Reset();
+	for (const FDelayHandle& Handle : Orphans)
+	{
+		const FDelayTimer& Timer = Timers[Handle.GetIndex()];
+		if (Timer.Generation == Handle.GetGeneration() && Timer.Action && !Timer.bExecuting)
+		{
+			ReleaseTimer(Handle.GetIndex());
+		}
+	}
+}
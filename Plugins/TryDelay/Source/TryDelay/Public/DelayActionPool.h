@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+/*
+* 延迟动作的内存池,按大小分级的空闲链表
+* 动作对象(连同其内联保存的Lambda和参数)从这里分配,释放后回到空闲链表,稳定状态下不再向系统申请内存
+* 池只在游戏线程使用,其他线程分配时直接向系统申请,释放时根据块头区分
+*/
+class TRYDELAY_API FDelayActionPool
+{
+public:
+	struct FSizeClassStats
+	{
+		//每块字节数,包含块头
+		int32 BlockSize = 0;
+		//正在使用的块
+		int32 NumUsed = 0;
+		//已向系统申请的块
+		int32 NumBlocks = 0;
+		//同时使用的最大块数
+		int32 HighWater = 0;
+	};
+
+	static FDelayActionPool& Get();
+
+	~FDelayActionPool();
+
+	void* Allocate(SIZE_T Size);
+	void Free(void* Ptr);
+
+	/*
+	* 获得各分级的统计
+	* @return				超出最大分级或不在游戏线程、直接向系统申请的次数
+	*/
+	int32 GetStats(TArray<FSizeClassStats>& OutStats) const;
+
+	void LogStats() const;
+
+private:
+	FDelayActionPool();
+
+	static constexpr int32 NumSizeClasses = 4;
+	static constexpr int32 BlocksPerPage = 64;
+	//块头保存分级,同时保证返回的地址16字节对齐
+	static constexpr int32 HeaderSize = 16;
+	static constexpr uint8 HeapSizeClass = 0xFF;
+
+	struct FFreeBlock
+	{
+		FFreeBlock* Next;
+	};
+
+	struct FSizeClass
+	{
+		FFreeBlock* FreeList = nullptr;
+		TArray<void*> Pages;
+		FSizeClassStats Stats;
+	};
+
+	void AllocatePage(FSizeClass& SizeClass);
+
+	FSizeClass SizeClasses[NumSizeClasses];
+	TAtomic<int32> NumHeapAllocations { 0 };
+};
@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* 延迟的句柄,由调度器中定时器的下标和代数组成
+* 定时器释放后代数加1,旧句柄随即失效
+*/
+struct FDelayHandle
+{
+	static constexpr uint32 IndexBits = 20;
+	static constexpr uint32 MaxIndex = (1u << IndexBits) - 1;
+	//int32标识符中只保存代数的低位
+	static constexpr uint32 UuidGenerationBits = 11;
+	static constexpr uint32 MaxUuidGeneration = (1u << UuidGenerationBits) - 1;
+
+	FDelayHandle() {}
+	FDelayHandle(uint32 InIndex, uint32 InGeneration) : Index(InIndex), Generation(InGeneration) {}
+
+	//代数为0的句柄无效
+	bool IsValid() const { return Generation != 0; }
+
+	uint32 GetIndex() const { return Index; }
+	uint32 GetGeneration() const { return Generation; }
+
+	/*
+	* 转换为蓝图及旧接口使用的int32标识符,无效句柄为-1
+	* 标识符只含代数的低位,同一下标复用MaxUuidGeneration次后会重复,需由调度器按当前代数解析
+	*/
+	int32 ToUuid() const
+	{
+		return IsValid() ? (int32)((ToUuidGeneration(Generation) << IndexBits) | Index) : -1;
+	}
+
+	/*
+	* 拆分int32标识符
+	* @return				不可能由ToUuid生成时返回false
+	*/
+	static bool SplitUuid(int32 uuid, uint32& OutIndex, uint32& OutUuidGeneration)
+	{
+		if (uuid <= 0)
+		{
+			return false;
+		}
+		OutIndex = (uint32)uuid & MaxIndex;
+		OutUuidGeneration = ((uint32)uuid >> IndexBits) & MaxUuidGeneration;
+		return OutUuidGeneration != 0 && ((uint32)uuid >> (IndexBits + UuidGenerationBits)) == 0;
+	}
+
+	//代数在标识符中的部分,范围为[1, MaxUuidGeneration]
+	static uint32 ToUuidGeneration(uint32 InGeneration)
+	{
+		return (InGeneration - 1) % MaxUuidGeneration + 1;
+	}
+
+	/*
+	* 下一代数,跳过0
+	*/
+	static uint32 NextGeneration(uint32 InGeneration)
+	{
+		return InGeneration == MAX_uint32 ? 1 : InGeneration + 1;
+	}
+
+	bool operator==(const FDelayHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FDelayHandle& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FDelayHandle& Handle)
+	{
+		return (Handle.Generation << IndexBits) | Handle.Index;
+	}
+
+private:
+	uint32 Index = 0;
+	uint32 Generation = 0;
+};
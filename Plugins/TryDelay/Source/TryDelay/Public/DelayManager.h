@@ -1,25 +1,122 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
-#include "DelayAction.h"
 #include "Templates/Function.h"
+#include "UObject/UnrealType.h"
+#include "UObject/TextProperty.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/ReflectedTypeAccessors.h"
+#include "Async/Future.h"
+#include "Templates/ValueOrError.h"
 #include "CommonUtilBPLibrary.h"
+#include "DelayActionPool.h"
 
-template<typename TLambda, typename...Args>
-bool Is_Bool_Ret(TLambda Lambda, Args...args)
+/*
+* 调用延迟动作时的附加信息
+*/
+struct FDelayFireInfo
 {
-	return sizeof(bool) == sizeof(decltype(Lambda(args...)));
-}
+	//本次调用合并的周期数,只有EDelayCatchUp::Coalesce会大于1
+	int32 Count = 1;
+	//本次调用原定的时间,为所用时钟上的截止时间,合并或跳过周期时为最早的一个
+	double ScheduledTime = 0.0;
+	//实际调用比原定时间晚了多少,单位同时钟(Frames时钟为帧数,其余为秒),可用于插值或弹道补偿
+	double Lateness = 0.0;
+};
 
-template<typename TLambda, typename... Args>
-class FTickableFunctor : public FPendingLatentAction
+class FParallelDelayActionBase;
+
+/*
+* 延迟动作基类,由UTryDelaySubsystem持有,到期时调用Execute
+*/
+class FDelayActionBase
 {
 public:
-	FTickableFunctor(TLambda InTriggerFunc, Args...args) : TriggerFunc(InTriggerFunc), Params(Forward<Args>(args)...) 
+	virtual ~FDelayActionBase() {}
+
+	//从FDelayActionPool分配
+	static void* operator new(SIZE_T Size) { return FDelayActionPool::Get().Allocate(Size); }
+	static void operator delete(void* Ptr) { FDelayActionPool::Get().Free(Ptr); }
+
+	/*
+	* @param Info		本次调用的附加信息
+	* @return			返回true时结束,返回false时按周期继续
+	*/
+	virtual bool Execute(const FDelayFireInfo& Info) = 0;
+
+	//可在工作线程计算的动作返回自身
+	virtual FParallelDelayActionBase* AsParallel() { return nullptr; }
+};
+
+/*
+* 计算部分可在工作线程执行的延迟动作,配合FDelayOptions::bThreadSafe使用
+* 到期时调度器先在工作线程中并行调用Compute,再在游戏线程按截止时间调用Complete应用结果
+*/
+class FParallelDelayActionBase : public FDelayActionBase
+{
+public:
+	virtual FParallelDelayActionBase* AsParallel() override { return this; }
+
+	//由调度器在工作线程中调用
+	void ComputeParallel()
 	{
-		checkf(Is_Bool_Ret(TriggerFunc, 1.0, args...), TEXT("Lambda Not Return Bool Or Param Not Have Float"));
+		if (!bComputed)
+		{
+			Compute();
+			bComputed = true;
+		}
 	}
 
+	//结果只在计算的那一帧有效,未应用时(如被推迟或回调中重置了时间)下次重新计算
+	void DiscardComputed() { bComputed = false; }
+
+	virtual bool Execute(const FDelayFireInfo& Info) override final
+	{
+		//未参与并行计算时(如FireAll补上的周期)在游戏线程计算
+		ComputeParallel();
+		bComputed = false;
+		return Complete(Info);
+	}
+
+protected:
+	//不能访问只能在游戏线程使用的对象
+	virtual void Compute() = 0;
+	/*
+	* @return			返回true时结束,返回false时按周期继续
+	*/
+	virtual bool Complete(const FDelayFireInfo& Info) = 0;
+
+private:
+	bool bComputed = false;
+};
+
+/*
+* 每帧调用的动作基类,由UTryDelaySubsystem持有
+*/
+class FTickableActionBase
+{
+public:
+	virtual ~FTickableActionBase() {}
+
+	//从FDelayActionPool分配
+	static void* operator new(SIZE_T Size) { return FDelayActionPool::Get().Allocate(Size); }
+	static void operator delete(void* Ptr) { FDelayActionPool::Get().Free(Ptr); }
+
+	/*
+	* @return			返回true时结束
+	*/
+	virtual bool Tick(float DeltaTime) = 0;
+};
+
+template<typename TLambda, typename... Args>
+class FTickableFunctor : public FTickableActionBase
+{
+public:
+	static_assert(Tmp::Is_Invocable_R_v<bool, TLambda, float, Args&...>, "ExecuteOnTick: lambda must be callable as bool(float DeltaTime, Args&...)");
+
+	template<typename InLambda, typename... InArgs>
+	FTickableFunctor(InLambda&& InTriggerFunc, InArgs&&... args) : TriggerFunc(Forward<InLambda>(InTriggerFunc)), Params(Forward<InArgs>(args)...) {}
+
 protected:
 	template<std::size_t... Index>
 	bool Execute(float DeltaTime, Tmp::Indices<Index...> Ind)
@@ -27,73 +124,251 @@ protected:
 		return TriggerFunc(DeltaTime, get<Index>(Params)...);
 	}
 
-	virtual void UpdateOperation(FLatentResponse& Response) override
+	virtual bool Tick(float DeltaTime) override
 	{
-		bool Ok = Execute(Response.ElapsedTime(), Tmp::build_inds<sizeof...(Args)>::type());
-		Response.DoneIf(Ok);
+		return Execute(DeltaTime, Tmp::build_inds<sizeof...(Args)>::type());
 	}
 private:
 	TLambda TriggerFunc;
 	TTuple<Args...> Params;
 };
 
-class FPendingLatentActionBase : public FPendingLatentAction
+namespace TryDelay
 {
-public:
-	FPendingLatentActionBase(float InDuration) : Duration(InDuration), StartDuration(InDuration) {}
-	void SetDuration(float InDuration) { Duration = InDuration; }
-	bool IsNextTick() const { return StartDuration < 0.0001f; }
-protected:
-	float Duration;
-	float StartDuration;
-};
+	template<typename T>
+	struct TIsObjectPtr : Tmp::false_type { using ObjectType = void; };
+	template<typename T>
+	struct TIsObjectPtr<TObjectPtr<T>> : Tmp::true_type { using ObjectType = T; };
+
+	template<typename T>
+	struct TIsEnumAsByte : Tmp::false_type {};
+	template<typename T>
+	struct TIsEnumAsByte<TEnumAsByte<T>> : Tmp::true_type { using EnumType = T; };
+
+	//是否有静态的StaticStruct(),即USTRUCT
+	template<typename T>
+	struct THasStaticStruct
+	{
+	private:
+		template<typename U, typename R = decltype(U::StaticStruct())>
+		static Tmp::true_type Test(void*);
+		template<typename U>
+		static Tmp::false_type Test(...);
+	public:
+		static constexpr bool value = decltype(Test<T>(nullptr))::value;
+	};
+
+	/*
+	* 函数参数Property是否为C++类型T,用于按参数写入前的检查
+	* 支持数值、bool、FString、FName、FText、UENUM、USTRUCT及常用数学结构体、UObject指针、TObjectPtr、TArray,其余类型一律不匹配
+	*/
+	template<typename T>
+	bool IsPropertyOfType(const FProperty* Property)
+	{
+		using U = std::remove_cv_t<T>;
+		if (Property == nullptr || Property->GetSize() != (int32)sizeof(U))
+		{
+			return false;
+		}
+
+		if constexpr (Tmp::is_same_v<U, bool>)
+		{
+			const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property);
+			return BoolProperty && BoolProperty->IsNativeBool();
+		}
+		else if constexpr (Tmp::is_same_v<U, int8>) return Property->IsA<FInt8Property>();
+		else if constexpr (Tmp::is_same_v<U, int16>) return Property->IsA<FInt16Property>();
+		else if constexpr (Tmp::is_same_v<U, int32>) return Property->IsA<FIntProperty>();
+		else if constexpr (Tmp::is_same_v<U, int64>) return Property->IsA<FInt64Property>();
+		else if constexpr (Tmp::is_same_v<U, uint8>)
+		{
+			//枚举的FByteProperty需用对应的枚举类型传入
+			const FByteProperty* ByteProperty = CastField<FByteProperty>(Property);
+			return ByteProperty && ByteProperty->Enum == nullptr;
+		}
+		else if constexpr (Tmp::is_same_v<U, uint16>) return Property->IsA<FUInt16Property>();
+		else if constexpr (Tmp::is_same_v<U, uint32>) return Property->IsA<FUInt32Property>();
+		else if constexpr (Tmp::is_same_v<U, uint64>) return Property->IsA<FUInt64Property>();
+		else if constexpr (Tmp::is_same_v<U, float>) return Property->IsA<FFloatProperty>();
+		else if constexpr (Tmp::is_same_v<U, double>) return Property->IsA<FDoubleProperty>();
+		else if constexpr (Tmp::is_same_v<U, FString>) return Property->IsA<FStrProperty>();
+		else if constexpr (Tmp::is_same_v<U, FName>) return Property->IsA<FNameProperty>();
+		else if constexpr (Tmp::is_same_v<U, FText>) return Property->IsA<FTextProperty>();
+		else if constexpr (TIsEnumAsByte<U>::value)
+		{
+			const FByteProperty* ByteProperty = CastField<FByteProperty>(Property);
+			return ByteProperty && ByteProperty->Enum == StaticEnum<typename TIsEnumAsByte<U>::EnumType>();
+		}
+		else if constexpr (TIsUEnumClass<U>::Value)
+		{
+			if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				return EnumProperty->GetEnum() == StaticEnum<U>();
+			}
+			const FByteProperty* ByteProperty = CastField<FByteProperty>(Property);
+			return ByteProperty && ByteProperty->Enum == StaticEnum<U>();
+		}
+		else if constexpr (Tmp::is_pointer<U>::value || TIsObjectPtr<U>::value)
+		{
+			using O = std::remove_cv_t<Tmp::conditional_t<TIsObjectPtr<U>::value, typename TIsObjectPtr<U>::ObjectType, std::remove_pointer_t<U>>>;
+			if constexpr (std::is_base_of_v<UObject, O>)
+			{
+				//弱指针、软指针等的内存布局不同,只接受FObjectProperty
+				const FObjectProperty* ObjectProperty = CastField<FObjectProperty>(Property);
+				return ObjectProperty && ObjectProperty->PropertyClass && O::StaticClass()->IsChildOf(ObjectProperty->PropertyClass);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else if constexpr (Tmp::is_any_of_v<U, FVector, FVector2D, FVector4, FRotator, FQuat, FTransform, FLinearColor, FColor, FGuid>)
+		{
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			return StructProperty && StructProperty->Struct == TBaseStructure<U>::Get();
+		}
+		else if constexpr (THasStaticStruct<U>::value)
+		{
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			return StructProperty && StructProperty->Struct == U::StaticStruct();
+		}
+		else if constexpr (TIsTArray<U>::Value)
+		{
+			if constexpr (Tmp::is_same_v<U, TArray<typename U::ElementType>>)
+			{
+				const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property);
+				return ArrayProperty && IsPropertyOfType<typename U::ElementType>(ArrayProperty->Inner);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else
+		{
+			return false;
+		}
+	}
+}
 
 /*
 * 延迟调用UFunction函数
+* 函数在调度时解析,参数内存按ParmsSize预先分配,调用时只复制参数
+* Args按顺序对应函数的参数,类型需与参数的Property一致(见TryDelay::IsPropertyOfType),返回bool时按返回值决定是否结束,否则调用一次后结束
 */
 template<typename...Args>
-class FUFunctionDelayAction : public FPendingLatentActionBase
+class FUFunctionDelayAction : public FDelayActionBase
 {
 public:
-	FUFunctionDelayAction(UObject* InCallbackTarget, float InDuration, FName InFunctionName, Args... args) : FPendingLatentActionBase(InDuration), CallbackTarget(InCallbackTarget), FunctionName(InFunctionName), Params(Forward<Args>(args)...) {}
+	template<typename... InArgs>
+	FUFunctionDelayAction(UObject* InCallbackTarget, FName InFunctionName, InArgs&&... args) : CallbackTarget(InCallbackTarget), FunctionName(InFunctionName), Params(Forward<InArgs>(args)...)
+	{
+		if (InCallbackTarget)
+		{
+			bInvalid = !Resolve(InCallbackTarget);
+		}
+	}
+
+	virtual ~FUFunctionDelayAction()
+	{
+		ReleaseParms();
+	}
 private:
-	UObject* CallbackTarget;
+	TWeakObjectPtr<UObject> CallbackTarget;
 	FName FunctionName;
 	TTuple<Args...> Params;
 
-	template<std::size_t... Index>
-	TTuple<Args..., bool> Execute(Tmp::Indices<Index...> Ind)
-	{
-		return TTuple<Args..., bool>(get<Index>(Params)..., bool());
-	}
+	TWeakObjectPtr<UFunction> Function;
+	uint8* Parms = nullptr;
+	FProperty* ParamProperties[sizeof...(Args) + 1] = {};
+	FBoolProperty* ReturnProperty = nullptr;
+	//函数不存在或参数不匹配
+	bool bInvalid = false;
 
-	virtual void UpdateOperation(FLatentResponse& Response) override
+	bool Resolve(UObject* Target)
 	{
-		if (CallbackTarget == nullptr) return;
+		UFunction* Func = Target->FindFunction(FunctionName);
+		if (Func == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Error Function Name: %s"), *FunctionName.ToString());
+			return false;
+		}
 
-		Duration -= Response.ElapsedTime();
-		bool Ok = Duration <= 0.f;
-		if (Ok)
+		int32 NumParams = 0;
+		ReturnProperty = nullptr;
+		for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
 		{
-			if (UFunction* ExecutionFunction = CallbackTarget->FindFunction(FunctionName))
+			if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+			{
+				ReturnProperty = CastField<FBoolProperty>(*It);
+			}
+			else if (NumParams++ < (int32)sizeof...(Args))
 			{
-				TTuple<Args..., bool> p = Execute(Tmp::build_inds<sizeof...(Args)>::type());
+				ParamProperties[NumParams - 1] = *It;
+			}
+		}
+		if (NumParams != (int32)sizeof...(Args) || !MatchParams(Tmp::build_inds<sizeof...(Args)>::type()))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Parameters Mismatch: %s"), *FunctionName.ToString());
+			return false;
+		}
+
+		Function = Func;
+		Parms = (uint8*)FMemory::Malloc(FMath::Max<int32>(Func->ParmsSize, 1), Func->GetMinAlignment());
+		FMemory::Memzero(Parms, Func->ParmsSize);
+		for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			It->InitializeValue_InContainer(Parms);
+		}
+		return true;
+	}
 
-				CallbackTarget->ProcessEvent(ExecutionFunction, &p);
-				Ok = get<sizeof...(Args)>(p);
+	void ReleaseParms()
+	{
+		if (Parms == nullptr) return;
 
-				Duration = StartDuration + Duration;
-				if (IsNextTick())
-				{
-					Ok = true;
-				}
-			}
-			else
+		if (UFunction* Func = Function.Get())
+		{
+			for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("Error Function Name: %s"), *FunctionName.ToString());
+				It->DestroyValue_InContainer(Parms);
 			}
 		}
-		Response.DoneIf(Ok);
+		FMemory::Free(Parms);
+		Parms = nullptr;
+	}
+
+	template<std::size_t... Index>
+	bool MatchParams(Tmp::Indices<Index...> Ind) const
+	{
+		return (TryDelay::IsPropertyOfType<Args>(ParamProperties[Index]) && ... && true);
+	}
+
+	template<std::size_t... Index>
+	void CopyParams(Tmp::Indices<Index...> Ind)
+	{
+		((*ParamProperties[Index]->ContainerPtrToValuePtr<Args>(Parms) = get<Index>(Params)), ...);
+	}
+
+	virtual bool Execute(const FDelayFireInfo& Info) override
+	{
+		UObject* Target = CallbackTarget.Get();
+		if (Target == nullptr || bInvalid) return true;
+
+		//蓝图重新编译后函数会被替换,需要重新解析
+		if (!Function.IsValid())
+		{
+			ReleaseParms();
+			if (!Resolve(Target)) return true;
+		}
+
+		CopyParams(Tmp::build_inds<sizeof...(Args)>::type());
+		if (ReturnProperty)
+		{
+			ReturnProperty->SetPropertyValue_InContainer(Parms, false);
+		}
+		Target->ProcessEvent(Function.Get(), Parms);
+		return ReturnProperty ? ReturnProperty->GetPropertyValue_InContainer(Parms) : true;
 	}
 };
 
@@ -101,129 +376,258 @@ private:
 * 延迟TFunction表达式
 */
 template<typename TLambda, typename...Args>
-class FLambdaDelayAction : public FPendingLatentActionBase
+class FLambdaDelayAction : public FDelayActionBase
 {
 public:
-	FLambdaDelayAction(float InDuration, TLambda InTriggerFunc, Args...args) : FPendingLatentActionBase(InDuration), TriggerFunc(InTriggerFunc), m_payload(Forward<Args>(args)...)
+	//表达式的第一个参数为const FDelayFireInfo&时传入调用信息
+	static constexpr bool bWantsFireInfo = Tmp::Is_Invocable_R_v<bool, TLambda, const FDelayFireInfo&, Args&...>;
+	static_assert(bWantsFireInfo || Tmp::Is_Invocable_R_v<bool, TLambda, Args&...>, "DelayLambda: lambda must be callable as bool(Args&...) or bool(const FDelayFireInfo&, Args&...), return true to stop or false to repeat");
+
+	template<typename InLambda, typename... InArgs>
+	FLambdaDelayAction(InLambda&& InTriggerFunc, InArgs&&... args) : TriggerFunc(Forward<InLambda>(InTriggerFunc)), m_payload(Forward<InArgs>(args)...) {}
+private:
+	TLambda TriggerFunc;
+	TTuple<Args...> m_payload;
+
+	template<std::size_t... Index>
+	bool Execute(const FDelayFireInfo& Info, Tmp::Indices<Index...> Ind)
 	{
-		checkf(Is_Bool_Ret(TriggerFunc, args...), TEXT("Lambda Not Return Bool"));
+		if constexpr (bWantsFireInfo)
+		{
+			return TriggerFunc(Info, get<Index>(m_payload)...);
+		}
+		else
+		{
+			return TriggerFunc(get<Index>(m_payload)...);
+		}
+	}
+	
+	virtual bool Execute(const FDelayFireInfo& Info) override
+	{
+		return Execute(Info, Tmp::build_inds<sizeof...(Args)>::type());
 	}
+};
+
+/*
+* 只调用一次的Lambda表达式,返回值(可为void)被忽略
+*/
+template<typename TLambda, typename...Args>
+class FOneShotLambdaDelayAction : public FDelayActionBase
+{
+public:
+	static_assert(Tmp::Is_Invocable_R_v<void, TLambda, Args&...>, "DelayChain/Debounce/Throttle: lambda must be callable with Args&...");
+
+	template<typename InLambda, typename... InArgs>
+	FOneShotLambdaDelayAction(InLambda&& InTriggerFunc, InArgs&&... args) : TriggerFunc(Forward<InLambda>(InTriggerFunc)), m_payload(Forward<InArgs>(args)...) {}
 private:
 	TLambda TriggerFunc;
 	TTuple<Args...> m_payload;
 
 	template<std::size_t... Index>
-	bool Execute(Tmp::Indices<Index...> Ind)
+	void Execute(Tmp::Indices<Index...> Ind)
 	{
-		return TriggerFunc(get<Index>(m_payload)...);
+		TriggerFunc(get<Index>(m_payload)...);
 	}
-	
-	virtual void UpdateOperation(FLatentResponse& Response) override
+
+	virtual bool Execute(const FDelayFireInfo& Info) override
 	{
-		Duration -= Response.ElapsedTime();
-		bool Ok = Duration <= 0.f;
-		if (Ok)
+		Execute(Tmp::build_inds<sizeof...(Args)>::type());
+		return true;
+	}
+};
+
+/*
+* 在工作线程中调用Work(Args&...),再在游戏线程中以其结果调用Completion
+* Work返回void时Completion没有参数
+*/
+template<typename TWork, typename TCompletion, typename...Args>
+class FParallelLambdaDelayAction : public FParallelDelayActionBase
+{
+	using TResult = decltype(DeclVal<TWork&>()(DeclVal<Args&>()...));
+	static constexpr bool bVoidResult = Tmp::is_same_v<TResult, void>;
+	using TStoredResult = Tmp::conditional_t<bVoidResult, bool, TResult>;
+public:
+	static_assert(bVoidResult ? Tmp::Is_Invocable_R_v<bool, TCompletion> : Tmp::Is_Invocable_R_v<bool, TCompletion, TStoredResult&>, "DelayParallel: completion must be callable as bool(Result&), or bool() when the work returns void");
+
+	template<typename InWork, typename InCompletion, typename... InArgs>
+	FParallelLambdaDelayAction(InWork&& InWorkFunc, InCompletion&& InCompletionFunc, InArgs&&... args) : WorkFunc(Forward<InWork>(InWorkFunc)), CompletionFunc(Forward<InCompletion>(InCompletionFunc)), Payload(Forward<InArgs>(args)...) {}
+private:
+	TWork WorkFunc;
+	TCompletion CompletionFunc;
+	TTuple<Args...> Payload;
+	TOptional<TStoredResult> Result;
+
+	template<std::size_t... Index>
+	void Compute(Tmp::Indices<Index...> Ind)
+	{
+		if constexpr (bVoidResult)
 		{
-			Ok = Execute(Tmp::build_inds<sizeof...(Args)>::type());
-			
-			Duration = StartDuration + Duration;
-			if (IsNextTick())
-			{
-				Ok = true;
-			}
+			WorkFunc(get<Index>(Payload)...);
+			Result.Emplace(true);
+		}
+		else
+		{
+			Result.Emplace(WorkFunc(get<Index>(Payload)...));
 		}
-		Response.DoneIf(Ok);
 	}
+
+	virtual void Compute() override
+	{
+		Compute(Tmp::build_inds<sizeof...(Args)>::type());
+	}
+
+	virtual bool Complete(const FDelayFireInfo& Info) override
+	{
+		bool bDone = true;
+		if constexpr (bVoidResult)
+		{
+			bDone = CompletionFunc();
+		}
+		else
+		{
+			bDone = CompletionFunc(Result.GetValue());
+		}
+		Result.Reset();
+		return bDone;
+	}
+};
+
+/*
+* 延迟的结果未能兑现的原因
+*/
+enum class EDelayError : uint8
+{
+	//到期前被取消,包括所有者结束、组被取消及调度器销毁
+	Cancelled,
+	//找不到调度器
+	NoScheduler,
 };
 
+template<typename T>
+using TDelayResult = TValueOrError<T, EDelayError>;
+
 /*
-* 延迟原生类成员函数
+* 延迟调用表达式,以返回值兑现TFuture,只调用一次
+* 没有调用就被销毁时以EDelayError::Cancelled兑现
 */
-template<typename... Args>
-class FRawDelayAction : public FPendingLatentActionBase
+template<typename TLambda, typename...Args>
+class FPromiseDelayAction : public FDelayActionBase
 {
 public:
-	template<typename C>
-	FRawDelayAction(float InDuration, C* p, bool(C::* pf)(Args...) , Args... args) : FPendingLatentActionBase(InDuration)
+	using TResult = decltype(DeclVal<TLambda&>()(DeclVal<Args&>()...));
+	static_assert(!Tmp::is_same_v<TResult, void>, "DelayLambdaFuture: lambda must return the value that fulfills the future");
+
+	template<typename InLambda, typename... InArgs>
+	FPromiseDelayAction(InLambda&& InTriggerFunc, InArgs&&... args) : TriggerFunc(Forward<InLambda>(InTriggerFunc)), Payload(Forward<InArgs>(args)...) {}
+
+	virtual ~FPromiseDelayAction()
 	{
-		TriggerFunc.BindRaw(p, pf, args...);
-	};
+		if (!bFulfilled)
+		{
+			Promise.SetValue(TDelayResult<TResult>(MakeError(EDelayError::Cancelled)));
+		}
+	}
+
+	TFuture<TDelayResult<TResult>> GetFuture() { return Promise.GetFuture(); }
+
+private:
+	TLambda TriggerFunc;
+	TTuple<Args...> Payload;
+	TPromise<TDelayResult<TResult>> Promise;
+	bool bFulfilled = false;
 
-	FRawDelayAction(float InDuration, const TDelegate<bool()>& InDelegate) : FPendingLatentActionBase(InDuration)
+	template<std::size_t... Index>
+	TResult Execute(Tmp::Indices<Index...> Ind)
 	{
-		TriggerFunc = InDelegate;
-	};
+		return TriggerFunc(get<Index>(Payload)...);
+	}
 
-	void SetDuration(float InDuration) { Duration = InDuration; }
+	virtual bool Execute(const FDelayFireInfo& Info) override
+	{
+		//先标记,后续中取消本延迟时不会再次兑现
+		bFulfilled = true;
+		Promise.SetValue(TDelayResult<TResult>(MakeValue(Execute(Tmp::build_inds<sizeof...(Args)>::type()))));
+		return true;
+	}
+};
+
+/*
+* 延迟原生类成员函数,参数内联保存
+*/
+template<class C, typename... Args>
+class FRawDelayAction : public FDelayActionBase
+{
+public:
+	using FuncPtr = bool(C::*)(Args...);
+
+	template<typename... InArgs>
+	FRawDelayAction(C* p, FuncPtr pf, InArgs&&... args) : Object(p), Func(pf), Payload(Forward<InArgs>(args)...) {}
 private:
-	TDelegate<bool(void)> TriggerFunc;
-	virtual void UpdateOperation(FLatentResponse& Response) override
+	C* Object;
+	FuncPtr Func;
+	TTuple<typename TDecay<Args>::Type...> Payload;
+
+	template<std::size_t... Index>
+	bool Execute(Tmp::Indices<Index...> Ind)
 	{
-		Duration -= Response.ElapsedTime();
-		bool Ok = Duration <= 0.f;
-		if (Ok)
-		{
-			if (TriggerFunc.IsBound())
-			{
-				Ok = TriggerFunc.Execute();
+		return (Object->*Func)(get<Index>(Payload)...);
+	}
 
-				Duration = StartDuration + Duration;
-				if (IsNextTick())
-				{
-					Ok = true;
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Warning, TEXT("Nothing To Execute"));
-			}
-		}
-		Response.DoneIf(Ok);
+	virtual bool Execute(const FDelayFireInfo& Info) override
+	{
+		return Execute(Tmp::build_inds<sizeof...(Args)>::type());
 	}
 };
 
 /*
-* 延迟UObject类成员函数
+* 延迟UObject类成员函数,参数内联保存,对象销毁后自动结束
 */
 template<class C, typename... Args>
-class FObjectDelayAction : public FPendingLatentActionBase
+class FObjectDelayAction : public FDelayActionBase
 {
 public:
 	using FuncPtr = bool(C::*)(Args...);
-	FObjectDelayAction(float InDuration, C* p, FuncPtr pf, Args... args) : FPendingLatentActionBase(InDuration)
+
+	template<typename... InArgs>
+	FObjectDelayAction(C* p, FuncPtr pf, InArgs&&... args) : Object(p), Func(pf), Payload(Forward<InArgs>(args)...) {}
+private:
+	TWeakObjectPtr<C> Object;
+	FuncPtr Func;
+	TTuple<typename TDecay<Args>::Type...> Payload;
+
+	template<std::size_t... Index>
+	bool Execute(C* Obj, Tmp::Indices<Index...> Ind)
 	{
-		TriggerFunc.BindUObject(p, pf, args...);
-	};
+		return (Obj->*Func)(get<Index>(Payload)...);
+	}
 
-	FObjectDelayAction(float InDuration, const TDelegate<bool()>& InDelegate) : FPendingLatentActionBase(InDuration)
+	virtual bool Execute(const FDelayFireInfo& Info) override
 	{
-		TriggerFunc = InDelegate;
-	};
+		if (C* Obj = Object.Get())
+		{
+			return Execute(Obj, Tmp::build_inds<sizeof...(Args)>::type());
+		}
+		return true;
+	}
+};
 
-	void SetDuration(float InDuration) { Duration = InDuration; }
+/*
+* 延迟调用已绑定的委托
+*/
+class FDelegateDelayAction : public FDelayActionBase
+{
+public:
+	FDelegateDelayAction(const TDelegate<bool()>& InDelegate) : TriggerFunc(InDelegate) {}
+	FDelegateDelayAction(TDelegate<bool()>&& InDelegate) : TriggerFunc(MoveTemp(InDelegate)) {}
 private:
 	TDelegate<bool(void)> TriggerFunc;
-	virtual void UpdateOperation(FLatentResponse& Response) override
+	virtual bool Execute(const FDelayFireInfo& Info) override
 	{
-		Duration -= Response.ElapsedTime();
-		bool Ok = Duration <= 0.f;
-		if (Ok)
+		if (TriggerFunc.IsBound())
 		{
-			if (TriggerFunc.IsBound())
-			{
-				Ok = TriggerFunc.Execute();
-
-				Duration = StartDuration + Duration;
-				if (IsNextTick())
-				{
-					Ok = true;
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Warning, TEXT("Nothing To Execute"));
-			}
+			return TriggerFunc.Execute();
 		}
-		Response.DoneIf(Ok);
+		UE_LOG(LogTemp, Warning, TEXT("Nothing To Execute"));
+		return true;
 	}
 };
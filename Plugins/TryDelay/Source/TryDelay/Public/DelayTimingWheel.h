@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* 分层时间轮
+* 第0层256个槽,其余每层64个槽,超出范围的放入溢出链表
+* 插入/删除为O(1),推进时按槽的占用位图直接跳到下一个到期或需要下沉的刻度,耗时与经过的时间无关
+*/
+class TRYDELAY_API FDelayTimingWheel
+{
+public:
+	FDelayTimingWheel();
+
+	/*
+	* 将Id放入时间轮,已在时间轮中时重新放置
+	* @param Id				外部标识(调度器的定时器下标)
+	* @param DeadlineTick	到期的刻度,小于等于当前刻度时下一刻度到期
+	*/
+	void Schedule(int32 Id, uint64 DeadlineTick);
+
+	/*
+	* 将Id从时间轮中移除
+	*/
+	void Cancel(int32 Id);
+
+	bool IsScheduled(int32 Id) const;
+
+	/*
+	* 推进到ToTick,到期的Id按槽顺序追加到OutDue
+	*/
+	void Advance(uint64 ToTick, TArray<int32>& OutDue);
+
+	/*
+	* 最早到期的刻度,没有定时器时返回false
+	* 先在第0层本圈剩余的槽中查找,找不到时只比较上层每层第一个非空的槽及溢出链表中的定时器
+	*/
+	bool GetNextDeadlineTick(uint64& OutTick) const;
+
+	void Reset();
+
+	uint64 GetCurrentTick() const { return CurrentTick; }
+	int32 Num() const { return NumScheduled; }
+
+private:
+	static constexpr int32 Level0Bits = 8;
+	static constexpr int32 LevelNBits = 6;
+	static constexpr int32 NumLevels = 4;
+	static constexpr int32 Level0Slots = 1 << Level0Bits;
+	static constexpr int32 LevelNSlots = 1 << LevelNBits;
+	static constexpr int32 NumSlots = Level0Slots + (NumLevels - 1) * LevelNSlots;
+	static constexpr int32 OverflowSlot = NumSlots;
+	static constexpr int32 WheelBits = Level0Bits + (NumLevels - 1) * LevelNBits;
+	static constexpr int32 NumOccupiedWords = NumSlots / 64;
+
+	struct FLink
+	{
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		int32 Slot = INDEX_NONE;
+		uint64 DeadlineTick = 0;
+	};
+
+	int32 SlotFor(uint64 Tick) const;
+	void Link(int32 Id, int32 Slot);
+	void Unlink(int32 Id);
+	void Cascade(int32 Slot);
+	//从Start开始循环查找[First, First + Count)中第一个非空的槽,返回与Start的距离,没有时返回INDEX_NONE
+	int32 FindOccupied(int32 First, int32 Count, int32 Start) const;
+	//当前刻度之后第一个有到期的槽或需要下沉的刻度,没有定时器时返回MAX_uint64
+	uint64 GetNextEventTick() const;
+
+	TArray<FLink> Links;
+	int32 Heads[NumSlots + 1];
+	//各槽(不含溢出链表)是否非空的位图
+	uint64 Occupied[NumOccupiedWords];
+	uint64 CurrentTick = 0;
+	int32 NumScheduled = 0;
+	TArray<int32> CascadeScratch;
+};
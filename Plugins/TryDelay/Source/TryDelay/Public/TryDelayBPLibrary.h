@@ -3,10 +3,10 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
-#include "DelayAction.h"
 #include "Templates/Function.h"
 #include "CommonUtilBPLibrary.h"
 #include "DelayManager.h"
+#include "TryDelaySubsystem.h"
 #include "TryDelayBPLibrary.generated.h"
 
 DECLARE_DELEGATE_RetVal(bool, FDelayDelegate);
@@ -21,7 +21,7 @@ public:
 	/**
 	* 根据函数名字延迟调用
 	* @param CallbackTarget			需要延迟调用函数的对象
-	* @param uuid					标识符,为-1时自动生成唯一标识符
+	* @param uuid					标识符,为-1或已失效时生成新的标识符,只能传入之前返回的值,自行指定的数值可能指向无关的延迟
 	* @param ExecutionFunction		需要延迟调用的函数名字
 	* @param Duration				延迟调用的时间
 	* @param bRetriggerable			是否能够重置时间
@@ -33,36 +33,251 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TryDelay")
 	static void DelayFunctionNameForNextTick(UObject* CallbackTarget, FName ExecutionFunction);
 
+	/**
+	* 根据函数名字延迟调用,并传入参数
+	* @param args					按顺序对应函数的参数,类型需与参数一致,保存在延迟动作中
+	* 其余参数同DelayFunctionName
+	*/
+	template<typename... InArgs>
+	static int32 DelayFunctionNameWithParams(UObject* CallbackTarget, int32 uuid, FName ExecutionFunction, float Duration, bool bRetriggerable, InArgs&&... args);
+
+	/**
+	* 取消延迟
+	* @param WorldContextObject		延迟所在世界的对象
+	* @param uuid					添加延迟时返回的标识符,标识符为下标与代数的组合,自行指定的数值可能指向无关的延迟
+	* @return						标识符不存在时返回false
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static bool CancelDelay(const UObject* WorldContextObject, int32 uuid);
+
+	/**
+	* 取消Owner的全部延迟,Actor结束游戏或对象销毁时会自动调用
+	* @param Owner					延迟的所有者,如DelayFunctionName的CallbackTarget
+	* @return						取消的延迟数
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay")
+	static int32 CancelDelaysForOwner(UObject* Owner);
+
+	/**
+	* 暂停组内的全部延迟
+	* @param WorldContextObject		延迟所在世界的对象
+	* @param Group					组名
+	* @return						组内的延迟数
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static int32 PauseDelayGroup(const UObject* WorldContextObject, FName Group);
+
+	/**
+	* 恢复组内的全部延迟
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static int32 ResumeDelayGroup(const UObject* WorldContextObject, FName Group);
+
+	/**
+	* 取消组内的全部延迟
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static int32 CancelDelayGroup(const UObject* WorldContextObject, FName Group);
+
+	/**
+	* 设置组的时间缩放,大于0
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static void SetDelayGroupTimeScale(const UObject* WorldContextObject, FName Group, float TimeScale);
+
+	/**
+	* 暂停延迟,保留剩余时间
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static bool PauseDelay(const UObject* WorldContextObject, int32 uuid);
+
+	/**
+	* 恢复暂停的延迟
+	*/
+	UFUNCTION(BlueprintCallable, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static bool ResumeDelay(const UObject* WorldContextObject, int32 uuid);
+
+	/**
+	* 获得延迟的剩余时间
+	* @return						标识符不存在时返回-1
+	*/
+	UFUNCTION(BlueprintPure, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static float GetRemainingTime(const UObject* WorldContextObject, int32 uuid);
+
+	/**
+	* 延迟是否存在且未暂停
+	*/
+	UFUNCTION(BlueprintPure, Category = "TryDelay", meta = (WorldContext = "WorldContextObject"))
+	static bool IsDelayActive(const UObject* WorldContextObject, int32 uuid);
+
 	/**
 	* 延迟调用Lambda表达式
-	* @param uuid					标识符,为-1时自动生成唯一标识符
+	* @param uuid					标识符,为-1或已失效时生成新的标识符
 	* @param Duration				延迟调用的时间
 	* @param bRetriggerable			是否能够重置时间
 	* @param InTriggerFunc			Lambda表达式
-	* @param args					重载参数,额外参数
+	* @param args					重载参数,额外参数,完美转发到延迟动作中保存,可以是只能移动的类型
 	* @return						返回标识符,可根据标识符在延迟时间前重置时间
 	*/
 	template<typename TLambda, typename...Args>
-	static int32 DelayLambda(int32 uuid, float Duration, bool bRetriggerable, TLambda InTriggerFunc, Args...args);
+	static int32 DelayLambda(int32 uuid, float Duration, bool bRetriggerable, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 在WorldContextObject所在的世界中延迟调用Lambda表达式,其余参数同上
+	*/
+	template<typename TLambda, typename...Args>
+	static int32 DelayLambda(const UObject* WorldContextObject, int32 uuid, float Duration, bool bRetriggerable, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 按可选参数延迟调用Lambda表达式,每次都添加新的延迟
+	* @param WorldContextObject		延迟所在世界的对象
+	* @param Duration				延迟调用的时间,同时也是重复调用的周期
+	* @param Options				可选参数,如重复调用落后时的补偿方式
+	* @param InTriggerFunc			Lambda表达式,第一个参数可为const FDelayFireInfo&
+	* @param args					额外参数
+	* @return						返回标识符
+	*/
+	template<typename TLambda, typename...Args>
+	static int32 DelayLambda(const UObject* WorldContextObject, float Duration, const FDelayOptions& Options, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 延迟调用Lambda表达式,以其返回值兑现返回的TFuture,只调用一次
+	* 到期前被取消(CancelDelay、所有者结束、组被取消或世界销毁)时以EDelayError::Cancelled兑现
+	* @param WorldContextObject		延迟所在世界的对象
+	* @param Duration				延迟调用的时间
+	* @param Options				可选参数
+	* @param OutUuid				可为nullptr,返回标识符,可用于CancelDelay
+	* @param InTriggerFunc			有返回值的Lambda表达式
+	* @param args					额外参数
+	* @return						兑现为返回值或错误的TFuture
+	*/
+	template<typename TLambda, typename...Args>
+	static TFuture<TDelayResult<typename FPromiseDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>::TResult>> DelayLambdaFuture(const UObject* WorldContextObject, float Duration, const FDelayOptions& Options, int32* OutUuid, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 按帧数延迟调用Lambda表达式
+	* @param WorldContextObject		延迟所在世界的对象
+	* @param NumFrames				延迟的帧数,同时也是重复调用的间隔帧数
+	* @param TickGroup				在哪个Tick组中调用,TG_MAX为调度器自身的Tick
+	* @param InTriggerFunc			Lambda表达式
+	* @param args					额外参数
+	* @return						返回标识符
+	*/
+	template<typename TLambda, typename...Args>
+	static int32 DelayFrames(const UObject* WorldContextObject, int32 NumFrames, ETickingGroup TickGroup, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 延迟调用线程安全的计算,同一帧到期的此类延迟在工作线程中并行执行
+	* @param WorldContextObject		延迟所在世界的对象
+	* @param Duration				延迟调用的时间,同时也是重复调用的周期
+	* @param Options				可选参数,bThreadSafe总为true
+	* @param InWorkFunc				在工作线程调用,参数为args,不能访问只能在游戏线程使用的对象
+	* @param InCompletionFunc		在游戏线程按截止时间调用,参数为InWorkFunc的返回值,返回true时结束
+	* @param args					额外参数,只在InWorkFunc中使用
+	* @return						返回标识符
+	*/
+	template<typename TWork, typename TCompletion, typename...Args>
+	static int32 DelayParallel(const UObject* WorldContextObject, float Duration, const FDelayOptions& Options, TWork&& InWorkFunc, TCompletion&& InCompletionFunc, Args&&...args);
+
+	/**
+	* 按指数退避轮询条件,代替每帧检查条件的ExecuteOnTick
+	* @param WorldContextObject		所在世界的对象
+	* @param InPredicate			返回bool的条件,如资源已加载、复制的Actor已存在
+	* @param MinInterval			首次轮询的间隔(秒)
+	* @param MaxInterval			轮询间隔的上限(秒)
+	* @param Timeout				超时时间(秒),小于0时不超时
+	* @param InOnSuccess			条件成立时调用
+	* @param InOnTimeout			超时时调用
+	* @return						返回标识符,条件已成立时为-1
+	*/
+	template<typename TPredicate, typename TOnSuccess, typename TOnTimeout>
+	static int32 DelayUntil(const UObject* WorldContextObject, TPredicate&& InPredicate, float MinInterval, float MaxInterval, float Timeout, TOnSuccess&& InOnSuccess, TOnTimeout&& InOnTimeout);
+
+	/**
+	* 开始延迟任务图,用返回句柄的Then、WhenAll、WhenAny组合后续步骤,整个任务图只需取消一次根节点
+	* @param WorldContextObject		任务图所在世界的对象
+	* @param Duration				第一步延迟调用的时间
+	* @param InTriggerFunc			Lambda表达式,只调用一次,返回值(可为void)被忽略
+	* @param args					额外参数
+	* @return						根节点的句柄
+	*/
+	template<typename TLambda, typename...Args>
+	static FDelayChainHandle DelayChain(const UObject* WorldContextObject, float Duration, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 防抖调用Lambda表达式,同一Key的连续调用在Window内合并
+	* @param WorldContextObject		所在世界的对象
+	* @param Key					防抖的键
+	* @param Window					窗口时间,每次调用都会推迟窗口
+	* @param Edge					Trailing为停止调用Window后调用最后一次传入的表达式,Leading为第一次调用时立即调用
+	* @param InTriggerFunc			Lambda表达式,返回值(可为void)被忽略
+	* @param args					额外参数
+	*/
+	template<typename TLambda, typename...Args>
+	static void Debounce(const UObject* WorldContextObject, FName Key, float Window, EDelayEdge Edge, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 节流调用Lambda表达式,同一Key在Interval内最多调用一次,参数同上
+	*/
+	template<typename TLambda, typename...Args>
+	static void Throttle(const UObject* WorldContextObject, FName Key, float Interval, EDelayEdge Edge, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 可在任意线程调用的延迟Lambda,下一帧起在游戏线程计时并调用
+	* @param WorldContextObject		延迟所在世界的对象,为nullptr时使用默认世界
+	* @param Duration				延迟调用的时间
+	* @param InTriggerFunc			Lambda表达式,在游戏线程调用
+	* @param args					额外参数
+	*/
+	template<typename TLambda, typename...Args>
+	static void DelayLambdaFromAnyThread(const UObject* WorldContextObject, float Duration, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 不带WorldContextObject的重载使用默认调度器
+	* 第一个参数为UObject指针时排除,以免WorldContextObject被当作表达式
+	*/
+	template<typename TLambda, typename...Args, typename = typename TEnableIf<!std::is_convertible_v<TLambda, const UObject*>>::Type>
+	static void DelayLambdaForNextTick(TLambda&& InTriggerFunc, Args&&...args);
 
 	template<typename TLambda, typename...Args>
-	static void DelayLambdaForNextTick(TLambda InTriggerFunc, Args...args);
+	static void DelayLambdaForNextTick(const UObject* WorldContextObject, TLambda&& InTriggerFunc, Args&&...args);
 
+	template<typename TLambda, typename... Args, typename = typename TEnableIf<!std::is_convertible_v<TLambda, const UObject*>>::Type>
+	static void ExecuteOnTick(TLambda&& InTriggerFunc, Args&&...args);
+
+	template<typename TLambda, typename... Args>
+	static void ExecuteOnTick(const UObject* WorldContextObject, TLambda&& InTriggerFunc, Args&&...args);
+
+	/**
+	* 按间隔调用Lambda表达式,返回true时结束
+	* @param WorldContextObject		所在世界的对象
+	* @param Interval				最短调用间隔(秒),如0.1为每100毫秒
+	* @param InTriggerFunc			Lambda表达式,DeltaTime为距上次调用累计的时间
+	* @param args					额外参数
+	*/
 	template<typename TLambda, typename... Args>
-	static void ExecuteOnTick(TLambda InTriggerFunc, Args...args);
+	static void ExecuteOnTickInterval(const UObject* WorldContextObject, float Interval, TLambda&& InTriggerFunc, Args&&...args);
 
 	/**
 	* 延迟调用UObject的类成员函数
 	* @param Obj					需要延迟调用函数的对象
-	* @param uuid					标识符,为-1时自动生成唯一标识符
+	* @param uuid					标识符,为-1或已失效时生成新的标识符
 	* @param Duration				延迟调用的时间
 	* @param bRetriggerable			是否能够重置时间
 	* @param pf						延迟调用的UObject成员函数
-	* @param args					重载参数,额外参数
+	* @param args					重载参数,额外参数,完美转发到延迟动作中保存
 	* @return						返回标识符,可根据标识符在延迟时间前重置时间
 	*/
-	template<class C, typename... Args>
-	static int32 DelayMemberFunction(UObject* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), Args... args);
+	template<class C, typename... Args, typename... InArgs>
+	static int32 DelayMemberFunction(UObject* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), InArgs&&... args);
+
+	/**
+	* 按可选参数延迟调用UObject的类成员函数,每次都添加新的延迟
+	* @param Options				可选参数,如重复调用的相位分散
+	* 其余参数同上
+	*/
+	template<class C, typename... Args, typename... InArgs>
+	static int32 DelayMemberFunction(UObject* Obj, float Duration, const FDelayOptions& Options, bool(C::* pf)(Args...), InArgs&&... args);
 
 	template<typename... Args>
 	static int32 DelayMemberFunction(int32 uuid, float Duration, const FDelayDelegate& InDelegate, bool bRetriggerable = false);
@@ -73,124 +288,253 @@ public:
 	/**
 	* 延迟调用原生C++类的成员函数
 	* @param Obj				需要调用的成员函数的类对象
-	* @param uuid				标识符,为-1时自动生成唯一标识符
+	* @param uuid				标识符,为-1或已失效时生成新的标识符
 	* @param Duration			延迟调用的时间
 	* @param bRetriggerable		是否能够重置时间
 	* @param pf					类成员函数指针
-	* @param args				需要调用的函数参数
+	* @param args				需要调用的函数参数,完美转发到延迟动作中保存
 	* @return					返回标识符,可根据标识符在延迟时间前重置时间
 	*/
-	template<class C, typename... Args>
-	static int32 DelayRawFunction(C* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), Args... args);
+	template<class C, typename... Args, typename... InArgs>
+	static int32 DelayRawFunction(C* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), InArgs&&... args);
+
+	/**
+	* 在WorldContextObject所在的世界中延迟调用原生C++类的成员函数,其余参数同上
+	*/
+	template<class C, typename... Args, typename... InArgs>
+	static int32 DelayRawFunction(const UObject* WorldContextObject, C* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), InArgs&&... args);
 
 	template<typename... Args>
 	static int32 DelayRawFunction(int32 uuid, float Duration, const FDelayDelegate& InDelegate, bool bRetriggerable = false);
 
+	template<typename... Args>
+	static int32 DelayRawFunction(const UObject* WorldContextObject, int32 uuid, float Duration, const FDelayDelegate& InDelegate, bool bRetriggerable = false);
+
 	template<typename... Args>
 	static void DelayRawFunctionForNextTick(const FDelayDelegate& InDelegate);
+
+private:
+	/*
+	* uuid有效时按需重置时间,否则用MakeAction创建新的延迟动作
+	*/
+	template<typename TFactory>
+	static int32 AddOrRetrigger(UTryDelaySubsystem* Scheduler, int32 uuid, float Duration, bool bRetriggerable, const UObject* Owner, TFactory&& MakeAction);
 };
 
-template<typename TLambda, typename...Args>
-void UTryDelayBPLibrary::ExecuteOnTick(TLambda InTriggerFunc, Args...args)
+template<typename TFactory>
+int32 UTryDelayBPLibrary::AddOrRetrigger(UTryDelaySubsystem* Scheduler, int32 uuid, float Duration, bool bRetriggerable, const UObject* Owner, TFactory&& MakeAction)
 {
-	auto FindWorld = [](UWorld* InWorld)->bool
+	if (Scheduler == nullptr) return -1;
+
+	FDelayHandle Handle = Scheduler->HandleFromUuid(uuid);
+	if (!Scheduler->HasDelay(Handle))
 	{
-		#if WITH_EDITOR || GIsEditor
-		if (InWorld->WorldType == EWorldType::PIE)	return true;
-		#else
-		if (InWorld->WorldType == EWorldType::Game || InWorld->WorldType == EWorldType::GamePreview) return true;
-		#endif
-		return false;
-	};
-
-	UWorld* World = UCommonUtilBPLibrary::ForEachWorld(FindWorld);
-	if (World == nullptr) World = GWorld ? GWorld->GetWorld() : nullptr;
-	if (World == nullptr) return;
-	if (World)
+		FDelayOptions Options;
+		Options.Owner = Owner;
+		Handle = Scheduler->AddDelay(Duration, MakeAction(), Options);
+	}
+	else
 	{
-		FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
-
-		uint32 uuid = UCommonUtilBPLibrary::GenerateUniqueID();
-
-		FTickableFunctor<TLambda, Args...>* DelayAction = LatentActionManager.FindExistingAction<FTickableFunctor<TLambda, Args...>>(World, uuid);
-		if (DelayAction == nullptr)
+		if (bRetriggerable)
 		{
-			LatentActionManager.AddNewAction(World, uuid, new FTickableFunctor<TLambda, Args...>(InTriggerFunc, args...));
+			Scheduler->RetriggerDelay(Handle, Duration);
 		}
 	}
+	return Handle.ToUuid();
+}
+
+template<typename... InArgs>
+int32 UTryDelayBPLibrary::DelayFunctionNameWithParams(UObject* CallbackTarget, int32 uuid, FName ExecutionFunction, float Duration, bool bRetriggerable, InArgs&&... args)
+{
+	return AddOrRetrigger(UTryDelaySubsystem::Get(CallbackTarget), uuid, Duration, bRetriggerable, CallbackTarget, [&]()
+		{
+			return new FUFunctionDelayAction<typename TDecay<InArgs>::Type...>(CallbackTarget, ExecutionFunction, Forward<InArgs>(args)...);
+		});
+}
+
+template<typename TLambda, typename...Args, typename>
+void UTryDelayBPLibrary::ExecuteOnTick(TLambda&& InTriggerFunc, Args&&...args)
+{
+	UTryDelayBPLibrary::ExecuteOnTick(UTryDelaySubsystem::GetDefault(), Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
 }
 
 template<typename TLambda, typename...Args>
-int32 UTryDelayBPLibrary::DelayLambda(int32 uuid, float Duration, bool bRetriggerable, TLambda InTriggerFunc, Args...args)
+void UTryDelayBPLibrary::ExecuteOnTick(const UObject* WorldContextObject, TLambda&& InTriggerFunc, Args&&...args)
 {
-	auto FindWorld = [](UWorld* InWorld)->bool
+	if (UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject))
 	{
-		#if WITH_EDITOR || GIsEditor
-		if (InWorld->WorldType == EWorldType::PIE)	return true;
-		#else
-		if (InWorld->WorldType == EWorldType::Game || InWorld->WorldType == EWorldType::GamePreview) return true;
-		#endif
-		return false;
-	};
-
-	UWorld* World = UCommonUtilBPLibrary::ForEachWorld(FindWorld);
-	if (World == nullptr) World = GWorld ? GWorld->GetWorld() : nullptr;
-	if (World == nullptr) return -1;
-
-	if (uuid == -1)
-	{
-		uuid = UCommonUtilBPLibrary::GenerateUniqueID();
+		Scheduler->AddTickable(new FTickableFunctor<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...));
 	}
+}
 
-	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
-	FLambdaDelayAction<TLambda, Args...>* LambdaDelayAction = LatentActionManager.FindExistingAction<FLambdaDelayAction<TLambda, Args...>>(World, uuid);
-	if (LambdaDelayAction == nullptr)
+template<typename TLambda, typename...Args>
+void UTryDelayBPLibrary::ExecuteOnTickInterval(const UObject* WorldContextObject, float Interval, TLambda&& InTriggerFunc, Args&&...args)
+{
+	if (UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject))
 	{
-		LatentActionManager.AddNewAction(World, uuid, new FLambdaDelayAction<TLambda, Args...>(Duration, InTriggerFunc, args...));
+		Scheduler->AddTickable(new FTickableFunctor<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...), Interval);
 	}
-	else
-	{
-		if (bRetriggerable)
+}
+
+template<typename TLambda, typename...Args>
+int32 UTryDelayBPLibrary::DelayLambda(int32 uuid, float Duration, bool bRetriggerable, TLambda&& InTriggerFunc, Args&&...args)
+{
+	return UTryDelayBPLibrary::DelayLambda(UTryDelaySubsystem::GetDefault(), uuid, Duration, bRetriggerable, Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+}
+
+template<typename TLambda, typename...Args>
+int32 UTryDelayBPLibrary::DelayLambda(const UObject* WorldContextObject, int32 uuid, float Duration, bool bRetriggerable, TLambda&& InTriggerFunc, Args&&...args)
+{
+	return AddOrRetrigger(UTryDelaySubsystem::Get(WorldContextObject), uuid, Duration, bRetriggerable, nullptr, [&]()
 		{
-			LambdaDelayAction->SetDuration(Duration);
-		}
-	}
-	return uuid;
+			return new FLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+		});
 }
 
 template<typename TLambda, typename...Args>
-void UTryDelayBPLibrary::DelayLambdaForNextTick(TLambda InTriggerFunc, Args...args)
+int32 UTryDelayBPLibrary::DelayLambda(const UObject* WorldContextObject, float Duration, const FDelayOptions& Options, TLambda&& InTriggerFunc, Args&&...args)
 {
-	UTryDelayBPLibrary::DelayLambda(-1, 0.0f, false, InTriggerFunc, args...);
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	if (Scheduler == nullptr) return -1;
+
+	FDelayActionBase* Action = new FLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+	return Scheduler->AddDelay(Duration, Action, Options).ToUuid();
 }
 
-template<class C, typename...Args>
-int32 UTryDelayBPLibrary::DelayMemberFunction(UObject* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), Args... args)
+template<typename TLambda, typename...Args>
+TFuture<TDelayResult<typename FPromiseDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>::TResult>> UTryDelayBPLibrary::DelayLambdaFuture(const UObject* WorldContextObject, float Duration, const FDelayOptions& Options, int32* OutUuid, TLambda&& InTriggerFunc, Args&&...args)
 {
-	UWorld* World = Obj->GetWorld();
-	if (World == nullptr)
-		return -1;
+	using FAction = FPromiseDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>;
+	if (OutUuid)
+	{
+		*OutUuid = -1;
+	}
+
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	if (Scheduler == nullptr)
+	{
+		TPromise<TDelayResult<typename FAction::TResult>> Promise;
+		Promise.SetValue(TDelayResult<typename FAction::TResult>(MakeError(EDelayError::NoScheduler)));
+		return Promise.GetFuture();
+	}
 
-	if (uuid == -1)
+	FAction* Action = new FAction(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+	TFuture<TDelayResult<typename FAction::TResult>> Future = Action->GetFuture();
+	const int32 Uuid = Scheduler->AddDelay(Duration, Action, Options).ToUuid();
+	if (OutUuid)
 	{
-		uuid = UCommonUtilBPLibrary::GenerateUniqueID();
+		*OutUuid = Uuid;
 	}
+	return Future;
+}
 
-	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
+template<typename TLambda, typename...Args>
+int32 UTryDelayBPLibrary::DelayFrames(const UObject* WorldContextObject, int32 NumFrames, ETickingGroup TickGroup, TLambda&& InTriggerFunc, Args&&...args)
+{
+	FDelayOptions Options;
+	Options.Clock = EDelayClock::Frames;
+	Options.TickGroup = TickGroup;
+	return UTryDelayBPLibrary::DelayLambda(WorldContextObject, (float)NumFrames, Options, Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+}
 
-	FObjectDelayAction<C, Args...>* ObjectDelayAction = LatentActionManager.FindExistingAction<FObjectDelayAction<C, Args...>>(Obj, uuid);
-	if (ObjectDelayAction == nullptr)
+template<typename TPredicate, typename TOnSuccess, typename TOnTimeout>
+int32 UTryDelayBPLibrary::DelayUntil(const UObject* WorldContextObject, TPredicate&& InPredicate, float MinInterval, float MaxInterval, float Timeout, TOnSuccess&& InOnSuccess, TOnTimeout&& InOnTimeout)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	if (Scheduler == nullptr) return -1;
+
+	FDelayOptions Options;
+	//大量等待者同一帧开始时错开轮询
+	Options.bSpreadPhase = true;
+	return Scheduler->DelayUntil(Forward<TPredicate>(InPredicate), MinInterval, MaxInterval, Timeout, Forward<TOnSuccess>(InOnSuccess), Forward<TOnTimeout>(InOnTimeout), Options).ToUuid();
+}
+
+template<typename TWork, typename TCompletion, typename...Args>
+int32 UTryDelayBPLibrary::DelayParallel(const UObject* WorldContextObject, float Duration, const FDelayOptions& Options, TWork&& InWorkFunc, TCompletion&& InCompletionFunc, Args&&...args)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	if (Scheduler == nullptr) return -1;
+
+	FDelayOptions ParallelOptions = Options;
+	ParallelOptions.bThreadSafe = true;
+	FDelayActionBase* Action = new FParallelLambdaDelayAction<typename TDecay<TWork>::Type, typename TDecay<TCompletion>::Type, typename TDecay<Args>::Type...>(Forward<TWork>(InWorkFunc), Forward<TCompletion>(InCompletionFunc), Forward<Args>(args)...);
+	return Scheduler->AddDelay(Duration, Action, ParallelOptions).ToUuid();
+}
+
+template<typename TLambda, typename...Args>
+FDelayChainHandle UTryDelayBPLibrary::DelayChain(const UObject* WorldContextObject, float Duration, TLambda&& InTriggerFunc, Args&&...args)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject);
+	if (Scheduler == nullptr) return FDelayChainHandle();
+
+	FDelayActionBase* Action = new FOneShotLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+	return Scheduler->StartChain(Duration, Action);
+}
+
+template<typename TLambda, typename...Args>
+void UTryDelayBPLibrary::Debounce(const UObject* WorldContextObject, FName Key, float Window, EDelayEdge Edge, TLambda&& InTriggerFunc, Args&&...args)
+{
+	if (UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject))
 	{
-		LatentActionManager.AddNewAction(Obj, uuid, new FObjectDelayAction<C, Args...>(Duration, Cast<C>(Obj), pf, args...));
+		Scheduler->Debounce(Key, Window, Edge, [&]()
+			{
+				return new FOneShotLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+			});
 	}
-	else
+}
+
+template<typename TLambda, typename...Args>
+void UTryDelayBPLibrary::Throttle(const UObject* WorldContextObject, FName Key, float Interval, EDelayEdge Edge, TLambda&& InTriggerFunc, Args&&...args)
+{
+	if (UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(WorldContextObject))
 	{
-		if (bRetriggerable)
+		Scheduler->Throttle(Key, Interval, Edge, [&]()
+			{
+				return new FOneShotLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+			});
+	}
+}
+
+template<typename TLambda, typename...Args>
+void UTryDelayBPLibrary::DelayLambdaFromAnyThread(const UObject* WorldContextObject, float Duration, TLambda&& InTriggerFunc, Args&&...args)
+{
+	UTryDelaySubsystem::EnqueueDelay(WorldContextObject, Duration, new FLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...));
+}
+
+template<typename TLambda, typename...Args, typename>
+void UTryDelayBPLibrary::DelayLambdaForNextTick(TLambda&& InTriggerFunc, Args&&...args)
+{
+	UTryDelayBPLibrary::DelayLambda(-1, 0.0f, false, Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+}
+
+template<typename TLambda, typename...Args>
+void UTryDelayBPLibrary::DelayLambdaForNextTick(const UObject* WorldContextObject, TLambda&& InTriggerFunc, Args&&...args)
+{
+	UTryDelayBPLibrary::DelayLambda(WorldContextObject, -1, 0.0f, false, Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+}
+
+template<class C, typename...Args, typename... InArgs>
+int32 UTryDelayBPLibrary::DelayMemberFunction(UObject* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), InArgs&&... args)
+{
+	return AddOrRetrigger(UTryDelaySubsystem::Get(Obj), uuid, Duration, bRetriggerable, Obj, [&]()
 		{
-			ObjectDelayAction->SetDuration(Duration);
-		}
+			return new FObjectDelayAction<C, Args...>(Cast<C>(Obj), pf, Forward<InArgs>(args)...);
+		});
+}
+
+template<class C, typename...Args, typename... InArgs>
+int32 UTryDelayBPLibrary::DelayMemberFunction(UObject* Obj, float Duration, const FDelayOptions& Options, bool(C::* pf)(Args...), InArgs&&... args)
+{
+	UTryDelaySubsystem* Scheduler = UTryDelaySubsystem::Get(Obj);
+	if (Scheduler == nullptr) return -1;
+
+	FDelayOptions OwnedOptions = Options;
+	if (OwnedOptions.Owner == nullptr)
+	{
+		OwnedOptions.Owner = Obj;
 	}
-	return uuid;
+	FDelayActionBase* Action = new FObjectDelayAction<C, Args...>(Cast<C>(Obj), pf, Forward<InArgs>(args)...);
+	return Scheduler->AddDelay(Duration, Action, OwnedOptions).ToUuid();
 }
 
 template<typename...Args>
@@ -200,31 +544,12 @@ int32 UTryDelayBPLibrary::DelayMemberFunction(int32 uuid, float Duration, const
 	checkf(Obj, TEXT("No Bound To UObject"));
 	if (Obj)
 	{
-		UWorld* World = Obj->GetWorld();
-		if (World == nullptr)
-			return -1;
-
-		if (uuid == -1)
-		{
-			uuid = UCommonUtilBPLibrary::GenerateUniqueID();
-		}
-
-		FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
-
-		FObjectDelayAction<UObject, Args...>* ObjectDelayAction = LatentActionManager.FindExistingAction<FObjectDelayAction<UObject, Args...>>(Obj, uuid);
-		if (ObjectDelayAction == nullptr)
-		{
-			LatentActionManager.AddNewAction(Obj, uuid, new FObjectDelayAction<UObject, Args...>(Duration, InDelegate));
-		}
-		else
-		{
-			if (bRetriggerable)
+		return AddOrRetrigger(UTryDelaySubsystem::Get(Obj), uuid, Duration, bRetriggerable, Obj, [&]()
 			{
-				ObjectDelayAction->SetDuration(Duration);
-			}
-		}
+				return new FDelegateDelayAction(InDelegate);
+			});
 	}
-	return uuid;
+	return -1;
 }
 
 template<typename...Args>
@@ -233,82 +558,34 @@ void UTryDelayBPLibrary::DelayMemberFunctionForNextTick(const FDelayDelegate& In
 	UTryDelayBPLibrary::DelayMemberFunction(-1, 0.0f, InDelegate, false);
 }
 
-template<class C, typename...Args>
-int32 UTryDelayBPLibrary::DelayRawFunction(C* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), Args... args)
+template<class C, typename...Args, typename... InArgs>
+int32 UTryDelayBPLibrary::DelayRawFunction(C* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), InArgs&&... args)
 {
-	auto FindWorld = [](UWorld* InWorld)->bool
-	{
-		#if WITH_EDITOR || GIsEditor
-		if (InWorld->WorldType == EWorldType::PIE)	return true;
-		#else
-		if (InWorld->WorldType == EWorldType::Game || InWorld->WorldType == EWorldType::GamePreview) return true;
-		#endif
-		return false;
-	};
-
-	UWorld* World = UCommonUtilBPLibrary::ForEachWorld(FindWorld);
-	if (World == nullptr) World = GWorld->GetWorld();
-	if (World == nullptr) return -1;
-
-	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
-
-	if (uuid == -1)
-	{
-		uuid = UCommonUtilBPLibrary::GenerateUniqueID();
-	}
+	return UTryDelayBPLibrary::DelayRawFunction(UTryDelaySubsystem::GetDefault(), Obj, uuid, Duration, bRetriggerable, pf, Forward<InArgs>(args)...);
+}
 
-	FRawDelayAction<Args...>* ObjectDelayAction = LatentActionManager.FindExistingAction<FRawDelayAction<Args...>>(World, uuid);
-	if (ObjectDelayAction == nullptr)
-	{
-		LatentActionManager.AddNewAction(World, uuid, new FRawDelayAction<Args...>(Duration, Obj, pf, args...));
-	}
-	else
-	{
-		if (bRetriggerable)
+template<class C, typename...Args, typename... InArgs>
+int32 UTryDelayBPLibrary::DelayRawFunction(const UObject* WorldContextObject, C* Obj, int32 uuid, float Duration, bool bRetriggerable, bool(C::* pf)(Args...), InArgs&&... args)
+{
+	return AddOrRetrigger(UTryDelaySubsystem::Get(WorldContextObject), uuid, Duration, bRetriggerable, nullptr, [&]()
 		{
-			ObjectDelayAction->SetDuration(Duration);
-		}
-	}
-	return uuid;
+			return new FRawDelayAction<C, Args...>(Obj, pf, Forward<InArgs>(args)...);
+		});
 }
 
 template<typename...Args>
 int32 UTryDelayBPLibrary::DelayRawFunction(int32 uuid, float Duration, const FDelayDelegate& InDelegate, bool bRetriggerable /*= false*/)
 {
-	auto FindWorld = [](UWorld* InWorld)->bool
-	{
-		#if WITH_EDITOR || GIsEditor
-		if (InWorld->WorldType == EWorldType::PIE)	return true;
-		#else
-		if (InWorld->WorldType == EWorldType::Game || InWorld->WorldType == EWorldType::GamePreview) return true;
-		#endif
-		return false;
-	};
-
-	UWorld* World = UCommonUtilBPLibrary::ForEachWorld(FindWorld);
-	if (World == nullptr) World = GWorld->GetWorld();
-	if (World == nullptr) return -1;
-
-	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
-
-	if (uuid == -1)
-	{
-		uuid = UCommonUtilBPLibrary::GenerateUniqueID();
-	}
+	return UTryDelayBPLibrary::DelayRawFunction(UTryDelaySubsystem::GetDefault(), uuid, Duration, InDelegate, bRetriggerable);
+}
 
-	FRawDelayAction<Args...>* ObjectDelayAction = LatentActionManager.FindExistingAction<FRawDelayAction<Args...>>(World, uuid);
-	if (ObjectDelayAction == nullptr)
-	{
-		LatentActionManager.AddNewAction(World, uuid, new FRawDelayAction<Args...>(Duration, InDelegate));
-	}
-	else
-	{
-		if (bRetriggerable)
+template<typename...Args>
+int32 UTryDelayBPLibrary::DelayRawFunction(const UObject* WorldContextObject, int32 uuid, float Duration, const FDelayDelegate& InDelegate, bool bRetriggerable /*= false*/)
+{
+	return AddOrRetrigger(UTryDelaySubsystem::Get(WorldContextObject), uuid, Duration, bRetriggerable, InDelegate.GetUObject(), [&]()
 		{
-			ObjectDelayAction->SetDuration(Duration);
-		}
-	}
-	return uuid;
+			return new FDelegateDelayAction(InDelegate);
+		});
 }
 
 template<typename...Args>
@@ -316,4 +593,3 @@ void UTryDelayBPLibrary::DelayRawFunctionForNextTick(const FDelayDelegate& InDel
 {
 	UTryDelayBPLibrary::DelayRawFunction(-1, 0.0f, InDelegate, false);
 }
-
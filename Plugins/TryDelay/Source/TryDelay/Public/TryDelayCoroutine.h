@@ -0,0 +1,172 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "TryDelaySubsystem.h"
+
+#if defined(__cpp_impl_coroutine)
+#define TRYDELAY_WITH_COROUTINES 1
+#include <coroutine>
+#else
+#define TRYDELAY_WITH_COROUTINES 0
+#endif
+
+#if TRYDELAY_WITH_COROUTINES
+namespace TryDelay
+{
+	/**
+	* 延迟协程,创建后立即执行,在co_await处挂起,由TryDelay调度器在游戏线程恢复
+	* 协程帧从FDelayActionPool分配,调度器销毁时未恢复的协程随之销毁
+	* ForExample:
+	*
+	* TryDelay::FDelayTask ATestDelayActor::Sequence()
+	* {
+	*	co_await TryDelay::Seconds(1.5f, this);
+	*	Print();
+	*	co_await TryDelay::NextTick(this);
+	*	co_await TryDelay::Frames(10, this);
+	*	Print();
+	* }
+	*/
+	class FDelayTask
+	{
+	public:
+		struct promise_type
+		{
+			FDelayTask get_return_object() { return FDelayTask(); }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() { checkf(false, TEXT("Unhandled Exception In TryDelay Coroutine")); }
+
+			static void* operator new(std::size_t Size) { return FDelayActionPool::Get().Allocate(Size); }
+			static void operator delete(void* Ptr) { FDelayActionPool::Get().Free(Ptr); }
+		};
+	};
+
+	/*
+	* 到期后恢复协程,没有恢复就被销毁时同时销毁协程
+	*/
+	class FCoroutineResumeAction : public FDelayActionBase
+	{
+	public:
+		explicit FCoroutineResumeAction(std::coroutine_handle<> InHandle) : Handle(InHandle) {}
+		virtual ~FCoroutineResumeAction()
+		{
+			if (Handle)
+			{
+				Handle.destroy();
+			}
+		}
+	private:
+		std::coroutine_handle<> Handle;
+
+		virtual bool Execute(const FDelayFireInfo& Info) override
+		{
+			std::coroutine_handle<> Resume = Handle;
+			Handle = nullptr;
+			Resume.resume();
+			return true;
+		}
+	};
+
+	/*
+	* 经过指定帧数后恢复协程
+	*/
+	class FCoroutineFramesAction : public FTickableActionBase
+	{
+	public:
+		FCoroutineFramesAction(std::coroutine_handle<> InHandle, int32 InFrames) : Handle(InHandle), RemainingFrames(InFrames) {}
+		virtual ~FCoroutineFramesAction()
+		{
+			if (Handle)
+			{
+				Handle.destroy();
+			}
+		}
+	private:
+		std::coroutine_handle<> Handle;
+		int32 RemainingFrames;
+
+		virtual bool Tick(float DeltaTime) override
+		{
+			if (--RemainingFrames > 0)
+			{
+				return false;
+			}
+			std::coroutine_handle<> Resume = Handle;
+			Handle = nullptr;
+			Resume.resume();
+			return true;
+		}
+	};
+
+	inline UTryDelaySubsystem* GetScheduler(const UObject* WorldContextObject)
+	{
+		return WorldContextObject ? UTryDelaySubsystem::Get(WorldContextObject) : UTryDelaySubsystem::GetDefault();
+	}
+
+	struct FSecondsAwaiter
+	{
+		float Duration;
+		const UObject* WorldContextObject;
+
+		bool await_ready() const { return false; }
+		bool await_suspend(std::coroutine_handle<> Handle) const
+		{
+			//找不到调度器时不挂起
+			UTryDelaySubsystem* Scheduler = GetScheduler(WorldContextObject);
+			if (Scheduler == nullptr)
+			{
+				return false;
+			}
+			Scheduler->AddDelay(Duration, new FCoroutineResumeAction(Handle));
+			return true;
+		}
+		void await_resume() const {}
+	};
+
+	struct FFramesAwaiter
+	{
+		int32 NumFrames;
+		const UObject* WorldContextObject;
+
+		bool await_ready() const { return NumFrames <= 0; }
+		bool await_suspend(std::coroutine_handle<> Handle) const
+		{
+			UTryDelaySubsystem* Scheduler = GetScheduler(WorldContextObject);
+			if (Scheduler == nullptr)
+			{
+				return false;
+			}
+			Scheduler->AddTickable(new FCoroutineFramesAction(Handle, NumFrames));
+			return true;
+		}
+		void await_resume() const {}
+	};
+
+	/*
+	* 等待Duration秒
+	* @param WorldContextObject		所在世界的对象,为nullptr时使用默认调度器
+	*/
+	inline FSecondsAwaiter Seconds(float Duration, const UObject* WorldContextObject = nullptr)
+	{
+		return FSecondsAwaiter{ Duration, WorldContextObject };
+	}
+
+	/*
+	* 等待到下一帧
+	*/
+	inline FSecondsAwaiter NextTick(const UObject* WorldContextObject = nullptr)
+	{
+		return FSecondsAwaiter{ 0.f, WorldContextObject };
+	}
+
+	/*
+	* 等待NumFrames帧
+	*/
+	inline FFramesAwaiter Frames(int32 NumFrames, const UObject* WorldContextObject = nullptr)
+	{
+		return FFramesAwaiter{ NumFrames, WorldContextObject };
+	}
+}
+#endif
@@ -0,0 +1,795 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/EngineTypes.h"
+#include "DelayManager.h"
+#include "DelayHandle.h"
+#include "DelayTimingWheel.h"
+#include "Containers/StaticArray.h"
+#include "CommonFunctionalClass.h"
+#include "TryDelaySubsystem.generated.h"
+
+/*
+* 重复延迟落后多个周期时(如卡顿)的补偿方式
+* 截止时间始终按周期累加,不受帧时间影响
+*/
+enum class EDelayCatchUp : uint8
+{
+	//每帧最多调用一次,落后的周期在之后的帧中逐次补上
+	Spread,
+	//在同一帧内补上所有落后的周期
+	FireAll,
+	//只调用一次,FDelayFireInfo::Count为合并的周期数
+	Coalesce,
+	//只调用一次,跳过落后的周期,下一次调用仍与原周期对齐
+	Skip,
+};
+
+/*
+* 延迟的优先级,开启每帧预算(TryDelay.FrameBudgetMs)时使用
+*/
+enum class EDelayPriority : uint8
+{
+	//超出预算时推迟到下一帧
+	Normal,
+	//不受预算限制,总在到期的帧调用
+	Critical,
+};
+
+/*
+* 延迟使用的时钟,Duration及剩余时间的单位随之变化
+* 每个时钟有单独的时间轮,世界暂停时只有Real、Unpaused时钟的延迟仍会调用
+*/
+enum class EDelayClock : uint8
+{
+	//调度器累计的Tick时间(秒),受时间膨胀影响,暂停时停止
+	Game,
+	//帧数,暂停时停止
+	Frames,
+	//真实时间(秒),不受时间膨胀及暂停影响
+	Real,
+	//音频时间(秒),同UWorld::GetAudioTimeSeconds,受时间膨胀影响,暂停时停止
+	Audio,
+	//受时间膨胀影响但不暂停的时间(秒)
+	Unpaused,
+};
+
+/*
+* 添加延迟时的可选参数
+*/
+struct FDelayOptions
+{
+	EDelayCatchUp CatchUp = EDelayCatchUp::Spread;
+	EDelayPriority Priority = EDelayPriority::Normal;
+	/*
+	* 重复延迟的相位分散:首次调用提前到(0, Duration]中由句柄决定的位置,之后按周期调用
+	* 同一帧添加的大量同周期延迟因此均匀分布在各帧,而不是每个周期集中在同一帧
+	*/
+	bool bSpreadPhase = false;
+	EDelayClock Clock = EDelayClock::Game;
+	/*
+	* 在指定的Tick组中调用,如TG_PrePhysics、TG_PostPhysics、TG_PostUpdateWork
+	* TG_MAX(默认)及TG_NewlySpawned在调度器自身的Tick中调用,位于所有Tick组之后
+	*/
+	ETickingGroup TickGroup = TG_MAX;
+	/*
+	* 延迟的所有者,所有者结束游戏(Actor的EndPlay)或销毁时取消其全部延迟
+	*/
+	const UObject* Owner = nullptr;
+	/*
+	* 延迟所属的组,可按组暂停、恢复、取消及缩放时间,NAME_None为不分组
+	* 使用FGameplayTag时传入Tag.GetTagName()
+	*/
+	FName Group = NAME_None;
+	/*
+	* 回调是线程安全的,需配合FParallelDelayActionBase使用
+	* 同一Tick组同一时钟中到期的此类延迟在工作线程中并行计算,再在游戏线程按截止时间应用结果
+	*/
+	bool bThreadSafe = false;
+};
+
+/*
+* 防抖及节流在窗口的哪一端调用
+*/
+enum class EDelayEdge : uint8
+{
+	//窗口开始时立即调用,窗口内的其余调用被丢弃
+	Leading,
+	//窗口结束时调用窗口内最后一次传入的函数
+	Trailing,
+	//开始时立即调用,窗口内还有调用时结束时再调用一次
+	Both,
+};
+
+class AActor;
+class UTryDelaySubsystem;
+struct FDelayChainHandle;
+
+/*
+* 在指定Tick组中派发该组延迟的Tick函数
+*/
+USTRUCT()
+struct FTryDelayTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UTryDelaySubsystem* Scheduler = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTryDelayTickFunction> : public TStructOpsTypeTraitsBase2<FTryDelayTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/*
+* TryDelay的调度器,每个世界一个
+* 延迟动作放在分层时间轮中,每帧只处理到期的动作
+*/
+UCLASS()
+class TRYDELAY_API UTryDelaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/*
+	* 获得WorldContextObject所在世界的调度器,结果按世界缓存,不遍历WorldContext
+	*/
+	static UTryDelaySubsystem* Get(const UObject* WorldContextObject);
+
+	/*
+	* 获得默认的调度器:最早初始化且仍存在的游戏世界(编辑器中为PIE世界),没有时使用GWorld
+	*/
+	static UTryDelaySubsystem* GetDefault();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	//暂停时仍需调用不暂停时钟的延迟
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual TStatId GetStatId() const override;
+
+	/*
+	* 添加延迟动作,调度器接管Action的生命周期
+	* @param Duration			延迟时间,同时也是重复调用的周期,小于等于0时只在下一帧调用一次,单位由Options.Clock决定
+	* @param Action				延迟动作
+	* @param Options			可选参数
+	* @return					延迟的句柄,Deinitialize后直接销毁Action并返回无效句柄
+	*/
+	FDelayHandle AddDelay(float Duration, FDelayActionBase* Action, const FDelayOptions& Options = FDelayOptions());
+
+	/*
+	* 重置延迟时间
+	* @return					句柄失效时返回false
+	*/
+	bool RetriggerDelay(FDelayHandle Handle, float Duration);
+
+	/*
+	* 将ToUuid得到的int32标识符解析为句柄,只在对应下标上的延迟仍为该代数时有效
+	* 标识符只含代数的低位,任意指定的数值仍可能指向无关的延迟,只应传入之前返回的标识符
+	*/
+	FDelayHandle HandleFromUuid(int32 uuid) const;
+
+	/*
+	* 句柄是否仍指向未结束的延迟
+	*/
+	bool HasDelay(FDelayHandle Handle) const;
+
+	/*
+	* 取消延迟,可在回调中调用
+	* @return					句柄失效时返回false
+	*/
+	bool CancelDelay(FDelayHandle Handle);
+
+	/*
+	* 取消所有者的全部延迟,耗时与该所有者的延迟数成正比
+	* @return					取消的延迟数
+	*/
+	int32 CancelDelaysForOwner(const UObject* Owner);
+
+	/*
+	* 暂停组内的全部延迟,之后加入该组的延迟也处于暂停状态
+	* @return					组内的延迟数
+	*/
+	int32 PauseGroup(FName Group);
+
+	/*
+	* 恢复组内的全部延迟
+	*/
+	int32 ResumeGroup(FName Group);
+
+	/*
+	* 取消组内的全部延迟
+	*/
+	int32 CancelGroup(FName Group);
+
+	/*
+	* 设置组的时间缩放,组内延迟的剩余时间及周期按比例变化,之后加入该组的延迟同样缩放
+	* @param TimeScale			大于0,为2时延迟以两倍速度到期
+	*/
+	void TimeScaleGroup(FName Group, float TimeScale);
+
+	float GetGroupTimeScale(FName Group) const;
+
+	/*
+	* 防抖:同一Key的调用间隔小于Window时合并,每次调用都将窗口推迟到Window之后
+	* 重置窗口只移动时间轮中的位置,函数只在需要调用或保存时由MakeAction创建
+	* @param Key				防抖的键
+	* @param Window				窗口时间
+	* @param Edge				调用的时机
+	* @param MakeAction			创建延迟动作,返回值被忽略
+	*/
+	template<typename TFactory>
+	void Debounce(FName Key, float Window, EDelayEdge Edge, TFactory&& MakeAction)
+	{
+		CallKeyed(ArmKeyed(Key, Window, true, Edge), Key, MakeAction);
+	}
+
+	/*
+	* 节流:同一Key在Interval内最多调用一次(Both时为开始和结束各一次),窗口不因后续调用推迟
+	* 参数同Debounce
+	*/
+	template<typename TFactory>
+	void Throttle(FName Key, float Interval, EDelayEdge Edge, TFactory&& MakeAction)
+	{
+		CallKeyed(ArmKeyed(Key, Interval, false, Edge), Key, MakeAction);
+	}
+
+	/*
+	* 取消Key的窗口及尚未调用的函数
+	*/
+	bool CancelKeyed(FName Key);
+
+	/*
+	* Key是否处于防抖或节流的窗口中
+	*/
+	bool IsKeyedActive(FName Key) const;
+
+	/*
+	* 开始延迟任务图,Duration后调用Action,返回的根节点可继续用Then、WhenAll、WhenAny组合
+	* 任务图中的节点只在依赖完成时才添加定时器,未开始的节点不占用时间轮
+	* @param Action				可为nullptr,只等待
+	*/
+	FDelayChainHandle StartChain(float Duration, FDelayActionBase* Action);
+
+	/*
+	* 节点完成后再等待Duration调用Action,Duration小于等于0时在依赖完成的同一帧调用
+	* 节点已完成时立即开始等待
+	* @return					所在任务图已结束或已取消时销毁Action并返回无效句柄
+	*/
+	FDelayChainHandle ThenChain(const FDelayChainHandle& After, float Duration, FDelayActionBase* Action);
+
+	/*
+	* 全部节点完成时完成的节点,属于第一个未结束的任务图
+	*/
+	FDelayChainHandle WhenAll(TArrayView<const FDelayChainHandle> Nodes);
+
+	/*
+	* 任一节点完成时完成的节点,全部依赖被取消时才取消
+	*/
+	FDelayChainHandle WhenAny(TArrayView<const FDelayChainHandle> Nodes);
+
+	/*
+	* 取消节点所在的整个任务图,依赖其节点的其它任务图一并取消,可在任务图的回调中调用
+	* @return					取消的节点数
+	*/
+	int32 CancelChain(const FDelayChainHandle& Handle);
+
+	/*
+	* 节点所在的任务图是否仍有未完成的节点
+	*/
+	bool IsChainActive(const FDelayChainHandle& Handle) const;
+
+	/*
+	* 按指数退避轮询条件,条件成立时调用OnSuccess,超时调用OnTimeout
+	* 每个等待者只占用时间轮中的一个定时器,间隔从MinInterval起每次翻倍直到MaxInterval
+	* 调用时先检查一次,已成立时立即调用OnSuccess并返回无效句柄
+	* @param Predicate			返回bool的条件
+	* @param MinInterval		首次轮询的间隔,大于0,单位由Options.Clock决定
+	* @param MaxInterval		轮询间隔的上限
+	* @param Timeout			超时时间,小于0时不超时
+	* @param OnSuccess			条件成立时调用
+	* @param OnTimeout			超时时调用
+	* @param Options			可选参数,大量等待者同时开始时可开启bSpreadPhase错开轮询的帧
+	* @return					轮询的句柄,取消后两个函数都不会调用
+	*/
+	template<typename TPredicate, typename TOnSuccess, typename TOnTimeout>
+	FDelayHandle DelayUntil(TPredicate&& Predicate, float MinInterval, float MaxInterval, float Timeout, TOnSuccess&& OnSuccess, TOnTimeout&& OnTimeout, const FDelayOptions& Options = FDelayOptions());
+
+	/*
+	* 暂停延迟,保留剩余时间
+	*/
+	bool PauseDelay(FDelayHandle Handle);
+
+	/*
+	* 恢复暂停的延迟,从剩余时间继续
+	*/
+	bool ResumeDelay(FDelayHandle Handle);
+
+	/*
+	* 获得剩余时间
+	* @return					句柄失效时返回-1
+	*/
+	float GetRemainingTime(FDelayHandle Handle) const;
+
+	/*
+	* 是否存在且未暂停
+	*/
+	bool IsDelayActive(FDelayHandle Handle) const;
+
+	/*
+	* 可在任意线程调用,请求放入无锁队列,由游戏线程上下一次调度器Tick取出后添加
+	* @param WorldContextObject	延迟所在世界的对象,为nullptr时使用默认调度器,调用期间需保证对象存活
+	* @param Duration			延迟时间
+	* @param Action				延迟动作,世界已不存在时直接销毁
+	*/
+	static void EnqueueDelay(const UObject* WorldContextObject, float Duration, FDelayActionBase* Action);
+
+	/*
+	* 销毁队列中尚未取出的请求,模块关闭时调用
+	*/
+	static void DiscardPendingRequests();
+
+	/*
+	* 添加每帧调用的动作,调度器接管Action的生命周期
+	* @param Action				每帧调用的动作,DeltaTime为距上次调用累计的时间
+	* @param Interval			最短调用间隔(秒),为0时每帧调用
+	*/
+	void AddTickable(FTickableActionBase* Action, float Interval = 0.f);
+
+	/*
+	* 开启或关闭模拟模式,用于测试及Commandlet
+	* 模拟模式下世界的Tick不再推进调度器,只由FastForward推进,Real、Audio、Unpaused时钟与Game时钟同步前进
+	* 关闭后这些时钟从模拟结束时的值起随世界的时间前进,不会回退
+	*/
+	void SetSimulationMode(bool bEnable);
+
+	bool IsSimulating() const { return bSimulating; }
+
+	/*
+	* 不经过世界Tick推进调度器,按截止时间顺序调用期间到期的全部延迟,未开启模拟模式时开启
+	* 每一步相当于一帧:Frames时钟加1,每帧调用的动作调用一次,不受每帧预算限制
+	* 不能在延迟的回调中调用
+	* @param Seconds			推进的时间(秒)
+	* @param StepSeconds		固定步长,小于等于0时每步直接跳到下一个到期的时间
+	* @return					调用的延迟数
+	*/
+	int32 FastForward(double Seconds, float StepSeconds = 0.f);
+
+	/*
+	* 调度器时间,为累计的Tick时间
+	*/
+	double GetTime() const { return CurrentTime; }
+
+	/*
+	* 时钟的当前值,单位同该时钟的Duration
+	*/
+	double GetClockTime(EDelayClock Clock) const;
+
+	//调用次数分布的区间数
+	static constexpr int32 NumFireBuckets = 12;
+
+	/*
+	* 每帧调用次数的分布,第0个为没有调用的帧数,第i个为调用次数在[2^(i-1), 2^i)中的帧数,最后一个包含更多的
+	* 同时累计到stat TryDelay的Frames With N Fires中,各世界共用
+	*/
+	const TStaticArray<uint32, NumFireBuckets>& GetFireHistogram() const { return FireHistogram; }
+
+	void ResetFireHistogram();
+
+private:
+	//定时器的侵入式双向链表节点
+	struct FTimerLink
+	{
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	struct FDelayTimer
+	{
+		FDelayActionBase* Action = nullptr;
+		double Deadline = 0.0;
+		float Period = 0.f;
+		//暂停时的剩余时间
+		float Remaining = 0.f;
+		//释放时加1,与句柄中的代数一致时句柄有效
+		uint32 Generation = 1;
+		EDelayCatchUp CatchUp = EDelayCatchUp::Spread;
+		EDelayPriority Priority = EDelayPriority::Normal;
+		EDelayClock Clock = EDelayClock::Game;
+		//所在的Tick组
+		uint8 TickGroup = DefaultTickGroup;
+		bool bPaused = false;
+		//超出预算,在FDelayBucket::Deferred中等待下一帧
+		bool bDeferred = false;
+		bool bExecuting = false;
+		//回调执行中被取消,执行结束后释放
+		bool bPendingCancel = false;
+		//所有者在GUObjectArray中的下标,及同一所有者的定时器链表
+		int32 OwnerIndex = INDEX_NONE;
+		FTimerLink OwnerLink;
+		//所在的组,及同一组的定时器链表
+		FName Group = NAME_None;
+		FTimerLink GroupLink;
+		//所在组的时间缩放,时钟上的周期为Period / TimeScale
+		float TimeScale = 1.f;
+		//到期时与同批的定时器并行计算
+		bool bThreadSafe = false;
+	};
+
+	struct FDelayGroup
+	{
+		int32 Head = INDEX_NONE;
+		float TimeScale = 1.f;
+		bool bPaused = false;
+	};
+
+	//所有者销毁时通知调度器
+	class FOwnerDeleteListener : public FOnUObjectDeleteListener
+	{
+	public:
+		FOwnerDeleteListener(UTryDelaySubsystem* InScheduler) : Scheduler(InScheduler) {}
+		virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override;
+	private:
+		UTryDelaySubsystem* Scheduler;
+	};
+
+	//同一Tick组同一时钟的定时器
+	struct FDelayBucket
+	{
+		FDelayTimingWheel Wheel;
+		//超出每帧预算推迟到下一帧的定时器,按截止时间排序
+		TArray<FDelayHandle> Deferred;
+	};
+
+	friend struct FTryDelayTickFunction;
+
+	//调度器自身Tick对应的组,排在所有Tick组之后
+	static constexpr int32 DefaultTickGroup = TG_MAX;
+	static constexpr int32 NumTickGroups = TG_MAX + 1;
+	static constexpr int32 NumClocks = (int32)EDelayClock::Unpaused + 1;
+
+	int32 AllocateTimer();
+	FDelayTimer* FindTimer(FDelayHandle Handle);
+	const FDelayTimer* FindTimer(FDelayHandle Handle) const;
+
+	static void DrainPendingRequests();
+
+	void HandleWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+	//推进时间及帧数,每帧在世界Tick开始时调用一次
+	void BeginFrame(float DeltaTime);
+	void TickInGroup(int32 TickGroup, float DeltaTime);
+	//更新每帧的统计
+	void EndFrame();
+	//模拟一帧,推进到NewTime并派发全部Tick组
+	int32 SimulateStep(double NewTime);
+	//以秒为单位的时钟中最早的截止时间,换算到Game时钟
+	double GetNextSimulatedDeadline() const;
+	//世界提供的时钟值,不含偏移
+	double GetWorldClockTime(EDelayClock Clock) const;
+	void TickFunctors(float DeltaTime);
+	void DispatchDueTimers(int32 TickGroup);
+	void DispatchBucket(FDelayBucket& Bucket, EDelayClock Clock, bool bUseBudget, double BudgetEndTime);
+	void FireTimer(int32 Index);
+	bool ExecuteTimer(int32 Index, const FDelayFireInfo& Info, int32 NumPeriods);
+	void ScheduleTimer(int32 Index);
+	void CancelTimer(int32 Index);
+	//按句柄取消仍有效的定时器,返回取消的数量
+	int32 CancelTimers(TArrayView<const FDelayHandle> Handles);
+	void ReleaseTimer(int32 Index);
+	FDelayBucket& GetBucket(int32 TickGroup, EDelayClock Clock);
+	FDelayTimingWheel& GetWheel(const FDelayTimer& Timer) const;
+	void RegisterTickFunction(int32 TickGroup);
+	void LinkTimer(int32 Index, FTimerLink FDelayTimer::* Link, int32& Head);
+	void UnlinkTimer(int32 Index, FTimerLink FDelayTimer::* Link, int32& Head);
+	void LinkOwner(int32 Index, const UObject* Owner);
+	void UnlinkOwner(int32 Index);
+	void LinkGroup(int32 Index, FName Group);
+	void UnlinkGroup(int32 Index);
+	//组为空且为默认状态时移除
+	void TrimGroup(FName Group);
+
+	enum class EKeyedCall : uint8
+	{
+		Discard,
+		FireNow,
+		SetPending,
+	};
+
+	//防抖或节流的窗口
+	struct FKeyedEntry
+	{
+		FDelayHandle Window;
+		//窗口结束时调用的函数
+		FDelayActionBase* Pending = nullptr;
+		bool bDebounce = false;
+	};
+
+	EKeyedCall ArmKeyed(FName Key, float Window, bool bDebounce, EDelayEdge Edge);
+	void SetKeyedPending(FName Key, FDelayActionBase* Action);
+	void FinishKeyed(FName Key);
+
+	template<typename TFactory>
+	void CallKeyed(EKeyedCall Call, FName Key, TFactory& MakeAction)
+	{
+		if (Call == EKeyedCall::FireNow)
+		{
+			FDelayActionBase* Action = MakeAction();
+			Action->Execute(FDelayFireInfo());
+			delete Action;
+		}
+		else if (Call == EKeyedCall::SetPending)
+		{
+			SetKeyedPending(Key, MakeAction());
+		}
+	}
+	int32 CancelOwner(int32 OwnerIndex);
+	//所有者在垃圾回收中被销毁,摘除其定时器,动作在下一帧开始时销毁
+	void OrphanOwner(int32 OwnerIndex);
+	void ReleaseOrphanedTimers();
+
+	//延迟任务图的节点
+	struct FChainNode
+	{
+		//等待结束后调用,可为nullptr
+		FDelayActionBase* Action = nullptr;
+		float Duration = 0.f;
+		uint32 Generation = 1;
+		//所在的任务图,及同一任务图的节点链表
+		int32 Chain = INDEX_NONE;
+		FTimerLink ChainLink;
+		//未完成的依赖数,WhenAny为未取消的依赖数
+		int32 NumPending = 0;
+		bool bAny = false;
+		//依赖已完成,正在等待Duration
+		bool bStarted = false;
+		bool bExecuting = false;
+		//回调执行中被取消,执行结束后释放
+		bool bPendingCancel = false;
+		FDelayHandle Timer;
+		//依赖该节点的节点
+		TArray<FDelayHandle, TInlineAllocator<2>> Successors;
+	};
+
+	struct FDelayChain
+	{
+		int32 Head = INDEX_NONE;
+		uint32 Generation = 1;
+	};
+
+	FChainNode* FindChainNode(FDelayHandle Handle);
+	const FDelayChain* FindChain(FDelayHandle Handle) const;
+	FDelayHandle AddChainNode(FDelayHandle Chain, float Duration, FDelayActionBase* Action);
+	FDelayChainHandle JoinChain(TArrayView<const FDelayChainHandle> Nodes, bool bAny);
+	//bInline时Duration小于等于0的节点立即完成,否则等到下一帧
+	void StartChainNode(int32 Index, bool bInline);
+	void CompleteChainNode(int32 Index);
+	void CancelChainNode(int32 Index);
+	int32 CancelChainAt(int32 ChainIndex);
+	void UnlinkChainNode(int32 Index);
+	void ReleaseChainNode(int32 Index);
+
+	UFUNCTION()
+	void HandleOwnerEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	double CurrentTime = 0.0;
+	uint64 FrameCount = 0;
+	//世界Tick开始(所有Tick组之前)时推进时间
+	FDelegateHandle PreActorTickHandle;
+	//本帧世界是否暂停,暂停时Game、Frames时钟及每帧调用的动作停止
+	bool bWorldPaused = false;
+	//模拟模式,及开启时各时钟与Game时钟的差
+	bool bSimulating = false;
+	double SimulationOffsets[NumClocks] = {};
+	//退出模拟后各时钟与世界时间的差,保持时钟连续
+	double ClockOffsets[NumClocks] = {};
+	//本帧派发已用的时间,各Tick组共用每帧预算
+	double FrameDispatchSeconds = 0.0;
+	bool bDispatching = false;
+	//本帧的调用次数
+	uint32 NumFiredThisFrame = 0;
+	TStaticArray<uint32, NumFireBuckets> FireHistogram;
+
+	//用到时才创建
+	TUniquePtr<FDelayBucket> Buckets[NumTickGroups][NumClocks];
+	TUniquePtr<FTryDelayTickFunction> TickFunctions[NumTickGroups];
+
+	TArray<FDelayTimer> Timers;
+	/*
+	* 释放的下标先进先出复用,且至少保留MinFreeTimers个不复用
+	* 同一下标的代数增长随之放慢,旧标识符在很长时间内不会与新延迟重复
+	*/
+	static constexpr int32 MinFreeTimers = 1024;
+	TArray<int32> FreeTimers;
+	int32 FreeTimersHead = 0;
+	//派发期间释放的下标,派发结束后才能复用
+	TArray<int32> PendingFreeTimers;
+	TArray<int32> DueTimers;
+	//本批并行计算的动作及其定时器
+	TArray<FParallelDelayActionBase*> ParallelActions;
+	TArray<FDelayHandle> ParallelTimers;
+
+	/*
+	* 每帧调用的动作,按列分开存放
+	* 未到间隔的只访问连续的时间数组,结束的动作与末尾交换后移除
+	*/
+	struct FTickableList
+	{
+		TArray<FTickableActionBase*> Actions;
+		TArray<float> Intervals;
+		TArray<float> Elapsed;
+
+		void Add(FTickableActionBase* Action, float Interval)
+		{
+			Actions.Add(Action);
+			Intervals.Add(Interval);
+			Elapsed.Add(0.f);
+		}
+
+		void RemoveAtSwap(int32 Index)
+		{
+			Actions.RemoveAtSwap(Index, 1, false);
+			Intervals.RemoveAtSwap(Index, 1, false);
+			Elapsed.RemoveAtSwap(Index, 1, false);
+		}
+	};
+
+	//所有者在GUObjectArray中的下标到其定时器链表头
+	TMap<int32, int32> OwnerHeads;
+	//所有者已销毁、等待销毁动作的定时器
+	TArray<FDelayHandle> OrphanedTimers;
+	TUniquePtr<FOwnerDeleteListener> OwnerDeleteListener;
+	TMap<FName, FDelayGroup> Groups;
+	TMap<FName, FKeyedEntry> KeyedEntries;
+
+	TArray<FChainNode> ChainNodes;
+	TArray<int32> FreeChainNodes;
+	TArray<FDelayChain> Chains;
+	TArray<int32> FreeChains;
+
+	FTickableList Tickables;
+	//TickFunctors期间添加的动作,从下一帧开始调用
+	FTickableList PendingTickables;
+	bool bTickingFunctors = false;
+	//Deinitialize后不再接受新的动作,传入的动作直接销毁
+	bool bDeinitialized = false;
+};
+
+/*
+* 延迟任务图中节点的句柄
+* 例:播放A,等待2秒,并行调用B和C,都结束后调用D
+*	FDelayChainHandle Wait = UTryDelayBPLibrary::DelayChain(this, 0.f, PlayA).Then(2.f, [] { return true; });
+*	FDelayChainHandle::WhenAll({ Wait.Then(0.f, RunB), Wait.Then(0.f, RunC) }).Then(0.f, RunD);
+*/
+struct FDelayChainHandle
+{
+	FDelayChainHandle() {}
+	FDelayChainHandle(UTryDelaySubsystem* InScheduler, FDelayHandle InNode, FDelayHandle InChain) : Scheduler(InScheduler), Node(InNode), Chain(InChain) {}
+
+	bool IsValid() const { return Chain.IsValid(); }
+
+	/*
+	* 本节点完成后等待Duration调用一次Lambda表达式,返回值(可为void)被忽略
+	*/
+	template<typename TLambda, typename...Args>
+	FDelayChainHandle Then(float Duration, TLambda&& InTriggerFunc, Args&&...args) const
+	{
+		UTryDelaySubsystem* InScheduler = Scheduler.Get();
+		if (InScheduler == nullptr) return FDelayChainHandle();
+
+		FDelayActionBase* Action = new FOneShotLambdaDelayAction<typename TDecay<TLambda>::Type, typename TDecay<Args>::Type...>(Forward<TLambda>(InTriggerFunc), Forward<Args>(args)...);
+		return InScheduler->ThenChain(*this, Duration, Action);
+	}
+
+	static FDelayChainHandle WhenAll(TArrayView<const FDelayChainHandle> Nodes)
+	{
+		UTryDelaySubsystem* InScheduler = Nodes.Num() > 0 ? Nodes[0].Scheduler.Get() : nullptr;
+		return InScheduler ? InScheduler->WhenAll(Nodes) : FDelayChainHandle();
+	}
+
+	static FDelayChainHandle WhenAny(TArrayView<const FDelayChainHandle> Nodes)
+	{
+		UTryDelaySubsystem* InScheduler = Nodes.Num() > 0 ? Nodes[0].Scheduler.Get() : nullptr;
+		return InScheduler ? InScheduler->WhenAny(Nodes) : FDelayChainHandle();
+	}
+
+	/*
+	* 取消所在的整个任务图
+	*/
+	int32 Cancel() const
+	{
+		UTryDelaySubsystem* InScheduler = Scheduler.Get();
+		return InScheduler ? InScheduler->CancelChain(*this) : 0;
+	}
+
+	bool IsActive() const
+	{
+		const UTryDelaySubsystem* InScheduler = Scheduler.Get();
+		return InScheduler && InScheduler->IsChainActive(*this);
+	}
+
+	TWeakObjectPtr<UTryDelaySubsystem> Scheduler;
+	FDelayHandle Node;
+	FDelayHandle Chain;
+};
+
+/*
+* 按指数退避轮询条件的延迟动作,由UTryDelaySubsystem::DelayUntil创建
+* 条件不成立时在回调中重置自身的延迟时间,不按周期重复
+*/
+template<typename TPredicate, typename TOnSuccess, typename TOnTimeout>
+class FPollDelayAction : public FDelayActionBase
+{
+public:
+	template<typename InPredicate, typename InOnSuccess, typename InOnTimeout>
+	FPollDelayAction(UTryDelaySubsystem* InScheduler, InPredicate&& InPredicateFunc, InOnSuccess&& InOnSuccessFunc, InOnTimeout&& InOnTimeoutFunc, float InInterval, float InMaxInterval, double InEndTime)
+		: Scheduler(InScheduler), Predicate(Forward<InPredicate>(InPredicateFunc)), OnSuccess(Forward<InOnSuccess>(InOnSuccessFunc)), OnTimeout(Forward<InOnTimeout>(InOnTimeoutFunc))
+		, Interval(InInterval), MaxInterval(InMaxInterval), EndTime(InEndTime) {}
+
+	FDelayHandle Handle;
+
+private:
+	UTryDelaySubsystem* Scheduler;
+	TPredicate Predicate;
+	TOnSuccess OnSuccess;
+	TOnTimeout OnTimeout;
+	float Interval;
+	float MaxInterval;
+	//超时的时钟时间,不超时为MAX_dbl
+	double EndTime;
+
+	virtual bool Execute(const FDelayFireInfo& Info) override
+	{
+		if (Predicate())
+		{
+			OnSuccess();
+			return true;
+		}
+
+		const double Now = Info.ScheduledTime + Info.Lateness;
+		if (Now >= EndTime)
+		{
+			OnTimeout();
+			return true;
+		}
+
+		//最后一次轮询正好在超时时
+		Interval = FMath::Min(Interval * 2.f, MaxInterval);
+		Scheduler->RetriggerDelay(Handle, (float)FMath::Min<double>(Interval, EndTime - Now));
+		return false;
+	}
+};
+
+template<typename TPredicate, typename TOnSuccess, typename TOnTimeout>
+FDelayHandle UTryDelaySubsystem::DelayUntil(TPredicate&& Predicate, float MinInterval, float MaxInterval, float Timeout, TOnSuccess&& OnSuccess, TOnTimeout&& OnTimeout, const FDelayOptions& Options)
+{
+	static_assert(Tmp::Is_Invocable_R_v<bool, typename TDecay<TPredicate>::Type&>, "DelayUntil: predicate must be callable as bool()");
+
+	if (Predicate())
+	{
+		OnSuccess();
+		return FDelayHandle();
+	}
+
+	//时间轮精度为1毫秒,间隔为0时无法退避
+	const float Interval = FMath::Max(MinInterval, 0.001f);
+	const double EndTime = Timeout < 0.f ? MAX_dbl : GetClockTime(Options.Clock) + Timeout;
+	using FAction = FPollDelayAction<typename TDecay<TPredicate>::Type, typename TDecay<TOnSuccess>::Type, typename TDecay<TOnTimeout>::Type>;
+	FAction* Action = new FAction(this, Forward<TPredicate>(Predicate), Forward<TOnSuccess>(OnSuccess), Forward<TOnTimeout>(OnTimeout), Interval, FMath::Max(MaxInterval, Interval), EndTime);
+	//Deinitialize后AddDelay会直接销毁Action,之后不能再访问
+	const FDelayHandle Handle = AddDelay(Timeout < 0.f ? Interval : FMath::Min(Interval, Timeout), Action, Options);
+	if (Handle.IsValid())
+	{
+		Action->Handle = Handle;
+	}
+	return Handle;
+}
@@ -7,6 +7,8 @@ public class TryDelay : ModuleRules
 	public TryDelay(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		//TryDelayCoroutine.h需要C++20协程
+		CppStandard = CppStandardVersion.Cpp20;
 		
 		PublicIncludePaths.AddRange(
 			new string[] {